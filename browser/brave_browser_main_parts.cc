@@ -11,6 +11,7 @@
 #include "brave/common/pref_names.h"
 #include "brave/components/brave_sync/buildflags/buildflags.h"
 #include "brave/components/brave_sync/features.h"
+#include "brave/components/p3a/buildflags.h"
 #include "brave/components/tor/buildflags/buildflags.h"
 #include "chrome/common/chrome_features.h"
 #include "components/prefs/pref_service.h"
@@ -42,6 +43,11 @@
 #include "chrome/browser/browser_process.h"
 #endif
 
+#if BUILDFLAG(BRAVE_P3A_ENABLED)
+#include "brave/browser/brave_browser_process_impl.h"
+#include "brave/components/p3a/brave_p3a_service.h"
+#endif
+
 #if BUILDFLAG(ENABLE_BRAVE_SYNC) && !defined(OS_ANDROID)
 #include "brave/browser/infobars/sync_v2_migrate_infobar_delegate.h"
 #include "components/sync/driver/sync_service.h"
@@ -121,6 +127,10 @@ void BraveBrowserMainParts::PostBrowserStart() {
 
 void BraveBrowserMainParts::PreShutdown() {
   content::BraveClearBrowsingData::ClearOnExit();
+#if BUILDFLAG(BRAVE_P3A_ENABLED)
+  // Runs before local state is committed on tear down.
+  g_brave_browser_process->brave_p3a_service()->OnShutdown();
+#endif
 }
 
 void BraveBrowserMainParts::PreProfileInit() {
@@ -3,10 +3,15 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include "base/barrier_closure.h"
 #include "base/base64.h"
 #include "base/path_service.h"
+#include "base/run_loop.h"
+#include "base/stl_util.h"
+#include "base/strings/stringprintf.h"
 #include "base/task/post_task.h"
 #include "base/test/thread_test_helper.h"
+#include "base/timer/elapsed_timer.h"
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/common/brave_paths.h"
 #include "brave/common/pref_names.h"
@@ -18,6 +23,7 @@
 #include "brave/components/brave_shields/browser/tracking_protection_service.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
 #include "brave/components/brave_shields/common/features.h"
+#include "brave/vendor/adblock_rust_ffi/src/wrapper.h"
 #include "chrome/browser/content_settings/host_content_settings_map_factory.h"
 #include "chrome/browser/extensions/extension_browsertest.h"
 #include "chrome/browser/ui/browser.h"
@@ -248,6 +254,54 @@ class AdBlockServiceTest : public ExtensionBrowserTest {
     ASSERT_TRUE(io_helper->Run());
   }
 
+  // Runs AdBlockService::ShouldStartRequests() on the ad block task runner in
+  // batches of |batch_size| and waits for all of them to finish.
+  void ShouldStartRequestsOnTaskRunner(
+      std::vector<brave_shields::AdBlockRequestInfo>* requests,
+      size_t batch_size) {
+    base::RunLoop run_loop;
+    const size_t batch_count = (requests->size() + batch_size - 1) / batch_size;
+    base::RepeatingClosure barrier =
+        base::BarrierClosure(batch_count, run_loop.QuitClosure());
+    for (size_t offset = 0; offset < requests->size(); offset += batch_size) {
+      base::span<brave_shields::AdBlockRequestInfo> batch =
+          base::make_span(*requests).subspan(
+              offset, std::min(batch_size, requests->size() - offset));
+      g_brave_browser_process->ad_block_service()->GetTaskRunner()->PostTask(
+          FROM_HERE, base::BindOnce(
+                         [](base::span<brave_shields::AdBlockRequestInfo> batch,
+                            base::OnceClosure done) {
+                           g_brave_browser_process->ad_block_service()
+                               ->ShouldStartRequests(batch);
+                           std::move(done).Run();
+                         },
+                         batch, barrier));
+    }
+    run_loop.Run();
+  }
+
+  base::Value UrlCosmeticResourcesOnTaskRunner(const std::string& url) {
+    base::Value result;
+    base::RunLoop run_loop;
+    base::PostTaskAndReplyWithResult(
+        g_brave_browser_process->ad_block_service()->GetTaskRunner().get(),
+        FROM_HERE,
+        base::BindOnce(&brave_shields::AdBlockService::UrlCosmeticResources,
+                       base::Unretained(
+                           g_brave_browser_process->ad_block_service()),
+                       url),
+        base::BindOnce(
+            [](base::Value* result, base::OnceClosure quit,
+               base::Optional<base::Value> resources) {
+              if (resources)
+                *result = std::move(*resources);
+              std::move(quit).Run();
+            },
+            &result, run_loop.QuitClosure()));
+    run_loop.Run();
+    return result;
+  }
+
   void WaitForBraveExtensionShieldsDataReady() {
     // Sometimes, the page can start loading before the Shields panel has
     // received information about the window and tab it's loaded in.
@@ -1173,3 +1227,200 @@ IN_PROC_BROWSER_TEST_F(AdBlockServiceTest,
 
   ASSERT_EQ(true, EvalJs(contents, "show_ad"));
 }
+
+// Batched matching must give the same results as matching each request on its
+// own, so both are checked against the results of the rules.
+IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, BatchedMatchingMatchesSingle) {
+  UpdateAdBlockInstanceWithRules(
+      "||ads.example.com^\n"
+      "@@||ads.example.com/allowed.png\n"
+      "||tracker.example.com^$important\n"
+      "/ad_banner.png\n");
+  ASSERT_TRUE(g_brave_browser_process->ad_block_custom_filters_service()
+                  ->UpdateCustomFilters("||custom.example.com^"));
+  WaitForAdBlockServiceThreads();
+
+  const struct {
+    const char* url;
+    bool did_match_rule;
+    bool did_match_exception;
+    bool did_match_important;
+  } kCases[] = {
+      {"https://ads.example.com/banner.png", true, false, false},
+      {"https://ads.example.com/allowed.png", false, true, false},
+      {"https://tracker.example.com/pixel.gif", true, false, true},
+      {"https://cdn.example.org/ad_banner.png", true, false, false},
+      {"https://custom.example.com/script.js", true, false, false},
+      {"https://example.net/logo.png", false, false, false},
+  };
+  std::vector<brave_shields::AdBlockRequestInfo> batched;
+  for (const auto& test_case : kCases) {
+    batched.emplace_back(GURL(test_case.url),
+                         blink::mojom::ResourceType::kImage, "example.net");
+  }
+  std::vector<brave_shields::AdBlockRequestInfo> single = batched;
+
+  ShouldStartRequestsOnTaskRunner(&batched, batched.size());
+  ShouldStartRequestsOnTaskRunner(&single, 1);
+
+  for (size_t i = 0; i < base::size(kCases); ++i) {
+    SCOPED_TRACE(kCases[i].url);
+    EXPECT_EQ(kCases[i].did_match_rule, batched[i].did_match_rule);
+    EXPECT_EQ(kCases[i].did_match_exception, batched[i].did_match_exception);
+    EXPECT_EQ(kCases[i].did_match_important, batched[i].did_match_important);
+    EXPECT_TRUE(batched[i].mock_data_url.empty());
+    EXPECT_EQ(kCases[i].did_match_rule, single[i].did_match_rule);
+    EXPECT_EQ(kCases[i].did_match_exception, single[i].did_match_exception);
+    EXPECT_EQ(kCases[i].did_match_important, single[i].did_match_important);
+    EXPECT_TRUE(single[i].mock_data_url.empty());
+  }
+}
+
+// Cosmetic resources are cached per hostname and dropped when an engine
+// changes.
+IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, CosmeticResourcesCacheInvalidation) {
+  UpdateAdBlockInstanceWithRules("a.com##.ad");
+  WaitForAdBlockServiceThreads();
+
+  base::Value first = UrlCosmeticResourcesOnTaskRunner("https://a.com/1");
+  ASSERT_TRUE(first.is_dict());
+  const base::Value* hide_selectors = first.FindListKey("hide_selectors");
+  ASSERT_TRUE(hide_selectors);
+  EXPECT_EQ(1u, hide_selectors->GetList().size());
+  EXPECT_EQ(first, UrlCosmeticResourcesOnTaskRunner("https://a.com/2"));
+
+  UpdateAdBlockInstanceWithRules("a.com##.ad\na.com##.banner");
+  WaitForAdBlockServiceThreads();
+
+  base::Value second = UrlCosmeticResourcesOnTaskRunner("https://a.com/1");
+  ASSERT_TRUE(second.is_dict());
+  hide_selectors = second.FindListKey("hide_selectors");
+  ASSERT_TRUE(hide_selectors);
+  EXPECT_EQ(2u, hide_selectors->GetList().size());
+}
+
+// A path specific $generichide exception isn't served to other pages of the
+// same host from the cache.
+IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, CosmeticResourcesCacheGenericHide) {
+  UpdateAdBlockInstanceWithRules("@@||a.com/nohide/$generichide");
+  WaitForAdBlockServiceThreads();
+
+  base::Value hidden = UrlCosmeticResourcesOnTaskRunner("https://a.com/page");
+  ASSERT_TRUE(hidden.is_dict());
+  EXPECT_EQ(base::Optional<bool>(false), hidden.FindBoolKey("generichide"));
+
+  base::Value excepted =
+      UrlCosmeticResourcesOnTaskRunner("https://a.com/nohide/page");
+  ASSERT_TRUE(excepted.is_dict());
+  EXPECT_EQ(base::Optional<bool>(true), excepted.FindBoolKey("generichide"));
+
+  hidden = UrlCosmeticResourcesOnTaskRunner("https://a.com/page#top");
+  ASSERT_TRUE(hidden.is_dict());
+  EXPECT_EQ(base::Optional<bool>(false), hidden.FindBoolKey("generichide"));
+}
+
+// Reports the per request cost of matching, including the task hop to the ad
+// block task runner, for different batch sizes. Run with --run-manual.
+IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, MANUAL_BatchedMatchingBenchmark) {
+  constexpr size_t kRuleCount = 5000;
+  constexpr size_t kRequestCount = 4096;
+
+  std::string rules;
+  for (size_t i = 0; i < kRuleCount; ++i)
+    rules += base::StringPrintf("||ads%zu.example.com^\n", i);
+  UpdateAdBlockInstanceWithRules(rules);
+  WaitForAdBlockServiceThreads();
+
+  std::vector<brave_shields::AdBlockRequestInfo> requests;
+  for (size_t i = 0; i < kRequestCount; ++i) {
+    requests.emplace_back(
+        GURL(base::StringPrintf("https://ads%zu.example.com/img%zu.png",
+                                (i * 7) % (2 * kRuleCount), i)),
+        blink::mojom::ResourceType::kImage, "example.net");
+  }
+
+  for (size_t batch_size : {1u, 16u, 256u}) {
+    std::vector<brave_shields::AdBlockRequestInfo> batch_requests = requests;
+    base::ElapsedTimer timer;
+    ShouldStartRequestsOnTaskRunner(&batch_requests, batch_size);
+    const base::TimeDelta elapsed = timer.Elapsed();
+    LOG(INFO) << "Batch size " << batch_size << ": "
+              << elapsed.InMicrosecondsF() / kRequestCount
+              << " us per request";
+  }
+}
+
+// Compares matching against the default engine followed by one engine per
+// regional list with matching against a single combined engine, for 0, 3
+// and 8 enabled regional lists. Run with --run-manual.
+IN_PROC_BROWSER_TEST_F(AdBlockServiceTest, MANUAL_CombinedEngineBenchmark) {
+  constexpr size_t kDefaultRuleCount = 5000;
+  constexpr size_t kRegionalRuleCount = 2000;
+  constexpr size_t kRequestCount = 4096;
+
+  std::string default_rules;
+  for (size_t i = 0; i < kDefaultRuleCount; ++i)
+    default_rules += base::StringPrintf("||ads%zu.example.com^\n", i);
+
+  std::vector<std::string> requests;
+  for (size_t i = 0; i < kRequestCount; ++i) {
+    requests.push_back(base::StringPrintf(
+        "https://ads%zu.example.com/img%zu.png",
+        (i * 7) % (2 * kDefaultRuleCount), i));
+  }
+
+  for (size_t list_count : {0u, 3u, 8u}) {
+    std::vector<std::unique_ptr<adblock::Engine>> chain;
+    chain.push_back(std::make_unique<adblock::Engine>(default_rules));
+    std::string combined_rules = default_rules;
+    for (size_t list = 0; list < list_count; ++list) {
+      std::string regional_rules;
+      for (size_t i = 0; i < kRegionalRuleCount; ++i) {
+        regional_rules +=
+            base::StringPrintf("||region%zu-ads%zu.example.org^\n", list, i);
+      }
+      chain.push_back(std::make_unique<adblock::Engine>(regional_rules));
+      combined_rules += regional_rules;
+    }
+    adblock::Engine combined(combined_rules);
+
+    size_t chain_matches = 0;
+    base::ElapsedTimer chain_timer;
+    for (const auto& url : requests) {
+      bool did_match_rule = false;
+      bool did_match_exception = false;
+      bool did_match_important = false;
+      std::string mock_data_url;
+      for (const auto& engine : chain) {
+        engine->matches(url, GURL(url).host(), "example.net", true, "image",
+                        &did_match_rule, &did_match_exception,
+                        &did_match_important, &mock_data_url);
+        if (did_match_important)
+          break;
+      }
+      chain_matches += did_match_rule;
+    }
+    const base::TimeDelta chain_elapsed = chain_timer.Elapsed();
+
+    size_t combined_matches = 0;
+    base::ElapsedTimer combined_timer;
+    for (const auto& url : requests) {
+      bool did_match_rule = false;
+      bool did_match_exception = false;
+      bool did_match_important = false;
+      std::string mock_data_url;
+      combined.matches(url, GURL(url).host(), "example.net", true, "image",
+                       &did_match_rule, &did_match_exception,
+                       &did_match_important, &mock_data_url);
+      combined_matches += did_match_rule;
+    }
+    const base::TimeDelta combined_elapsed = combined_timer.Elapsed();
+
+    EXPECT_EQ(chain_matches, combined_matches);
+    LOG(INFO) << list_count << " regional lists: chained "
+              << chain_elapsed.InMicrosecondsF() / kRequestCount
+              << " us, combined "
+              << combined_elapsed.InMicrosecondsF() / kRequestCount
+              << " us per request";
+  }
+}
@@ -0,0 +1,74 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/brave_ad_block_cname_cache.h"
+
+#include <memory>
+#include <utility>
+
+#include "base/time/default_tick_clock.h"
+#include "base/time/tick_clock.h"
+#include "content/public/browser/browser_context.h"
+
+namespace brave {
+
+namespace {
+
+const char kAdBlockCnameCacheKey[] = "brave_ad_block_cname_cache";
+
+constexpr size_t kCnameCacheSize = 1024;
+// Same as the default TTL of the host cache for system resolver results.
+constexpr base::TimeDelta kCnameCacheTTL = base::TimeDelta::FromMinutes(1);
+
+}  // namespace
+
+// static
+AdBlockCnameCache* AdBlockCnameCache::FromBrowserContext(
+    content::BrowserContext* browser_context) {
+  AdBlockCnameCache* cache = static_cast<AdBlockCnameCache*>(
+      browser_context->GetUserData(kAdBlockCnameCacheKey));
+  if (!cache) {
+    // Object cleanup is handled by SupportsUserData
+    auto new_cache = std::make_unique<AdBlockCnameCache>(
+        base::DefaultTickClock::GetInstance());
+    cache = new_cache.get();
+    browser_context->SetUserData(kAdBlockCnameCacheKey, std::move(new_cache));
+  }
+  return cache;
+}
+
+AdBlockCnameCache::AdBlockCnameCache(const base::TickClock* clock)
+    : clock_(clock), entries_(kCnameCacheSize) {
+  DETACH_FROM_SEQUENCE(sequence_checker_);
+}
+
+AdBlockCnameCache::~AdBlockCnameCache() = default;
+
+bool AdBlockCnameCache::Get(
+    const net::NetworkIsolationKey& network_isolation_key,
+    const std::string& host,
+    std::string* canonical_name) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  auto it = entries_.Get(std::make_pair(network_isolation_key, host));
+  if (it == entries_.end())
+    return false;
+  if (it->second.expiration <= clock_->NowTicks()) {
+    entries_.Erase(it);
+    return false;
+  }
+  *canonical_name = it->second.canonical_name;
+  return true;
+}
+
+void AdBlockCnameCache::Put(
+    const net::NetworkIsolationKey& network_isolation_key,
+    const std::string& host,
+    const std::string& canonical_name) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  entries_.Put(std::make_pair(network_isolation_key, host),
+               Entry{canonical_name, clock_->NowTicks() + kCnameCacheTTL});
+}
+
+}  // namespace brave
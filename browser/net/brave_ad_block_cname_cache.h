@@ -0,0 +1,76 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_CNAME_CACHE_H_
+#define BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_CNAME_CACHE_H_
+
+#include <string>
+#include <utility>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+#include "base/memory/weak_ptr.h"
+#include "base/sequence_checker.h"
+#include "base/supports_user_data.h"
+#include "base/time/time.h"
+#include "net/base/network_isolation_key.h"
+
+namespace base {
+class TickClock;
+}  // namespace base
+
+namespace content {
+class BrowserContext;
+}  // namespace content
+
+namespace brave {
+
+// Remembers the canonical names resolved for ad block CNAME uncloaking, per
+// network isolation key, so that repeated requests to the same host don't
+// wait for the resolver again. Entries expire after a fixed TTL since the
+// resolver doesn't report the record TTL. Each browser context has its own
+// cache, so that off the record profiles don't share entries with the others.
+class AdBlockCnameCache : public base::SupportsUserData::Data {
+ public:
+  static AdBlockCnameCache* FromBrowserContext(
+      content::BrowserContext* browser_context);
+
+  explicit AdBlockCnameCache(const base::TickClock* clock);
+  ~AdBlockCnameCache() override;
+
+  // Returns false if there's no fresh entry for |host|.
+  bool Get(const net::NetworkIsolationKey& network_isolation_key,
+           const std::string& host,
+           std::string* canonical_name);
+  void Put(const net::NetworkIsolationKey& network_isolation_key,
+           const std::string& host,
+           const std::string& canonical_name);
+
+  size_t size() const { return entries_.size(); }
+
+  base::WeakPtr<AdBlockCnameCache> AsWeakPtr() {
+    return weak_factory_.GetWeakPtr();
+  }
+
+ private:
+  struct Entry {
+    std::string canonical_name;
+    base::TimeTicks expiration;
+  };
+
+  const base::TickClock* clock_;
+  base::MRUCache<std::pair<net::NetworkIsolationKey, std::string>, Entry>
+      entries_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+
+  base::WeakPtrFactory<AdBlockCnameCache> weak_factory_{this};
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockCnameCache);
+};
+
+}  // namespace brave
+
+#endif  // BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_CNAME_CACHE_H_
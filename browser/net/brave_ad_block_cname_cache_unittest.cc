@@ -0,0 +1,58 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/browser/net/brave_ad_block_cname_cache.h"
+
+#include <string>
+
+#include "base/test/simple_test_tick_clock.h"
+#include "net/base/network_isolation_key.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "url/gurl.h"
+#include "url/origin.h"
+
+namespace brave {
+
+namespace {
+
+net::NetworkIsolationKey CreateKey(const std::string& site) {
+  const url::Origin origin = url::Origin::Create(GURL(site));
+  return net::NetworkIsolationKey(origin, origin);
+}
+
+}  // namespace
+
+TEST(BraveAdBlockCnameCacheTest, StoresPerNetworkIsolationKey) {
+  base::SimpleTestTickClock clock;
+  AdBlockCnameCache cache(&clock);
+  const net::NetworkIsolationKey a_key = CreateKey("https://a.com");
+  const net::NetworkIsolationKey b_key = CreateKey("https://b.com");
+
+  std::string canonical_name;
+  EXPECT_FALSE(cache.Get(a_key, "cdn.a.com", &canonical_name));
+
+  cache.Put(a_key, "cdn.a.com", "a.tracker.net");
+  EXPECT_TRUE(cache.Get(a_key, "cdn.a.com", &canonical_name));
+  EXPECT_EQ("a.tracker.net", canonical_name);
+  EXPECT_FALSE(cache.Get(b_key, "cdn.a.com", &canonical_name));
+  EXPECT_FALSE(cache.Get(a_key, "www.a.com", &canonical_name));
+}
+
+TEST(BraveAdBlockCnameCacheTest, EntriesExpire) {
+  base::SimpleTestTickClock clock;
+  AdBlockCnameCache cache(&clock);
+  const net::NetworkIsolationKey key = CreateKey("https://a.com");
+
+  cache.Put(key, "cdn.a.com", "a.tracker.net");
+  clock.Advance(base::TimeDelta::FromSeconds(30));
+  std::string canonical_name;
+  EXPECT_TRUE(cache.Get(key, "cdn.a.com", &canonical_name));
+
+  clock.Advance(base::TimeDelta::FromSeconds(30));
+  EXPECT_FALSE(cache.Get(key, "cdn.a.com", &canonical_name));
+  EXPECT_EQ(0u, cache.size());
+}
+
+}  // namespace brave
@@ -11,8 +11,13 @@
 #include <vector>
 
 #include "base/base64url.h"
+#include "base/memory/ref_counted.h"
+#include "base/no_destructor.h"
 #include "base/strings/string_util.h"
+#include "base/synchronization/lock.h"
+#include "base/task/post_task.h"
 #include "brave/browser/brave_browser_process_impl.h"
+#include "brave/browser/net/brave_ad_block_cname_cache.h"
 #include "brave/browser/net/url_context.h"
 #include "brave/common/network_constants.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
@@ -52,48 +57,98 @@ content::WebContents* GetWebContents(int render_process_id,
   return web_contents;
 }
 
-}  // namespace
+using AdBlockCheckCallback =
+    base::OnceCallback<void(brave_shields::AdBlockRequestInfo)>;
+
+struct PendingAdBlockCheck {
+  PendingAdBlockCheck(std::shared_ptr<BraveRequestInfo> ctx,
+                      const base::Optional<std::string>& canonical_name,
+                      AdBlockCheckCallback callback)
+      : ctx(std::move(ctx)),
+        canonical_name(canonical_name),
+        callback(std::move(callback)) {}
+
+  std::shared_ptr<BraveRequestInfo> ctx;
+  base::Optional<std::string> canonical_name;
+  // Result of matching the request URL in an earlier check, in which case
+  // only the canonical URL is matched.
+  base::Optional<brave_shields::AdBlockRequestInfo> request_url_result;
+  // Receives |result| on the UI thread.
+  AdBlockCheckCallback callback;
+  base::Optional<brave_shields::AdBlockRequestInfo> result;
+};
 
-void ShouldBlockAdOnTaskRunner(std::shared_ptr<BraveRequestInfo> ctx,
-                               base::Optional<std::string> canonical_name) {
-  bool did_match_rule = false;
-  bool did_match_exception = false;
-  bool did_match_important = false;
-  if (!ctx->initiator_url.is_valid()) {
-    return;
-  }
-  std::string source_host = ctx->initiator_url.host();
+bool IsBlocked(const brave_shields::AdBlockRequestInfo& result) {
+  return result.did_match_important ||
+         (result.did_match_rule && !result.did_match_exception);
+}
 
-  g_brave_browser_process->ad_block_service()->ShouldStartRequest(
-      ctx->request_url, ctx->resource_type, source_host, &did_match_rule,
-      &did_match_exception, &did_match_important, &ctx->mock_data_url);
-  if (did_match_important) {
-    ctx->blocked_by = kAdBlocked;
-    return;
+// Returns the request URL with its host replaced by |canonical_name|, or an
+// empty URL if the CNAME doesn't point elsewhere.
+GURL GetCanonicalURL(const GURL& request_url,
+                     const base::Optional<std::string>& canonical_name) {
+  if (!canonical_name.has_value() || canonical_name->empty() ||
+      request_url.host() == *canonical_name) {
+    return GURL();
   }
+  GURL::Replacements replacements = GURL::Replacements();
+  replacements.SetHost(
+      canonical_name->c_str(),
+      url::Component(0, static_cast<int>(canonical_name->length())));
+  return request_url.ReplaceComponents(replacements);
+}
 
-  if (canonical_name.has_value() &&
-      ctx->request_url.host() != *canonical_name && *canonical_name != "") {
-    GURL::Replacements replacements = GURL::Replacements();
-    replacements.SetHost(
-        canonical_name->c_str(),
-        url::Component(0, static_cast<int>(canonical_name->length())));
-    const GURL canonical_url = ctx->request_url.ReplaceComponents(replacements);
-
-    g_brave_browser_process->ad_block_service()->ShouldStartRequest(
-        ctx->request_url, ctx->resource_type, source_host, &did_match_rule,
-        &did_match_exception, &did_match_important, &ctx->mock_data_url);
+void ShouldBlockAdsOnTaskRunner(std::vector<PendingAdBlockCheck>* checks) {
+  std::vector<brave_shields::AdBlockRequestInfo> requests;
+  std::vector<PendingAdBlockCheck*> request_checks;
+  requests.reserve(checks->size());
+  request_checks.reserve(checks->size());
+  for (auto& check : *checks) {
+    if (!check.ctx->initiator_url.is_valid() || check.request_url_result)
+      continue;
+    requests.emplace_back(check.ctx->request_url, check.ctx->resource_type,
+                          check.ctx->initiator_url.host());
+    requests.back().mock_data_url = check.ctx->mock_data_url;
+    request_checks.push_back(&check);
   }
 
-  if (did_match_important || (did_match_rule && !did_match_exception)) {
-    ctx->blocked_by = kAdBlocked;
+  brave_shields::AdBlockService* ad_block_service =
+      g_brave_browser_process->ad_block_service();
+  ad_block_service->ShouldStartRequests(requests);
+
+  for (size_t i = 0; i < requests.size(); ++i)
+    request_checks[i]->result = std::move(requests[i]);
+
+  std::vector<brave_shields::AdBlockRequestInfo> results;
+  std::vector<base::Optional<std::string>> canonical_names;
+  std::vector<PendingAdBlockCheck*> result_checks;
+  for (auto& check : *checks) {
+    if (check.request_url_result)
+      check.result = std::move(check.request_url_result);
+    if (!check.result || !check.canonical_name)
+      continue;
+    results.push_back(std::move(*check.result));
+    canonical_names.push_back(check.canonical_name);
+    result_checks.push_back(&check);
   }
+  if (results.empty())
+    return;
+
+  MatchCanonicalURLs(
+      base::BindRepeating(&brave_shields::AdBlockService::ShouldStartRequests,
+                          base::Unretained(ad_block_service)),
+      canonical_names, &results);
+  for (size_t i = 0; i < results.size(); ++i)
+    result_checks[i]->result = std::move(results[i]);
 }
 
 void OnShouldBlockAdResult(const ResponseCallback& next_callback,
-                           std::shared_ptr<BraveRequestInfo> ctx) {
+                           std::shared_ptr<BraveRequestInfo> ctx,
+                           brave_shields::AdBlockRequestInfo result) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
-  if (ctx->blocked_by == kAdBlocked) {
+  ctx->mock_data_url = result.mock_data_url;
+  if (IsBlocked(result)) {
+    ctx->blocked_by = kAdBlocked;
     brave_shields::DispatchBlockedEvent(
         ctx->request_url, ctx->render_frame_id, ctx->render_process_id,
         ctx->frame_tree_node_id, brave_shields::kAds);
@@ -101,15 +156,184 @@ void OnShouldBlockAdResult(const ResponseCallback& next_callback,
   next_callback.Run();
 }
 
+void OnShouldBlockAdResults(std::vector<PendingAdBlockCheck> checks) {
+  for (auto& check : checks) {
+    // Requests without a valid initiator aren't matched at all.
+    if (!check.result) {
+      check.result.emplace(check.ctx->request_url, check.ctx->resource_type,
+                           std::string());
+      check.result->mock_data_url = check.ctx->mock_data_url;
+    }
+    std::move(check.callback).Run(std::move(*check.result));
+  }
+}
+
+// Collects the ad block checks of requests arriving on the UI thread. All
+// checks queued while the ad block task runner is busy are matched by one
+// task, with one ShouldStartRequests() call, and answered by one reply, so a
+// burst of subresource requests doesn't cost a thread hop per request.
+class AdBlockCheckBatcher {
+ public:
+  static AdBlockCheckBatcher* GetInstance() {
+    static base::NoDestructor<AdBlockCheckBatcher> instance;
+    return instance.get();
+  }
+
+  void Add(scoped_refptr<base::SequencedTaskRunner> task_runner,
+           PendingAdBlockCheck check) {
+    base::AutoLock lock(lock_);
+    pending_checks_.push_back(std::move(check));
+    if (drain_scheduled_)
+      return;
+    drain_scheduled_ = true;
+    task_runner->PostTask(FROM_HERE,
+                          base::BindOnce(&AdBlockCheckBatcher::Drain,
+                                         base::Unretained(this)));
+  }
+
+ private:
+  friend class base::NoDestructor<AdBlockCheckBatcher>;
+
+  AdBlockCheckBatcher() = default;
+  ~AdBlockCheckBatcher() = default;
+
+  void Drain() {
+    std::vector<PendingAdBlockCheck> checks;
+    {
+      base::AutoLock lock(lock_);
+      checks.swap(pending_checks_);
+      drain_scheduled_ = false;
+    }
+
+    ShouldBlockAdsOnTaskRunner(&checks);
+    base::PostTask(FROM_HERE, {content::BrowserThread::UI},
+                   base::BindOnce(&OnShouldBlockAdResults, std::move(checks)));
+  }
+
+  base::Lock lock_;
+  std::vector<PendingAdBlockCheck> pending_checks_;
+  bool drain_scheduled_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(AdBlockCheckBatcher);
+};
+
+// Matches the request URL while its CNAME is being resolved. Requests which
+// are blocked by their own URL are answered without waiting for the
+// resolver; the others are matched again against the canonical URL once it
+// is known. Only used on the UI thread.
+class CnameUncloakingCheck : public base::RefCounted<CnameUncloakingCheck> {
+ public:
+  CnameUncloakingCheck(const ResponseCallback& next_callback,
+                       scoped_refptr<base::SequencedTaskRunner> task_runner,
+                       std::shared_ptr<BraveRequestInfo> ctx)
+      : next_callback_(next_callback),
+        task_runner_(std::move(task_runner)),
+        ctx_(std::move(ctx)) {}
+
+  void Start() {
+    AdBlockCheckBatcher::GetInstance()->Add(
+        task_runner_,
+        PendingAdBlockCheck(
+            ctx_, base::nullopt,
+            base::BindOnce(&CnameUncloakingCheck::OnRequestURLResult, this)));
+  }
+
+  void OnCanonicalName(base::Optional<std::string> canonical_name) {
+    DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+    resolved_ = true;
+    canonical_name_ = std::move(canonical_name);
+    MaybeMatchCanonicalURL();
+  }
+
+ private:
+  friend class base::RefCounted<CnameUncloakingCheck>;
+  ~CnameUncloakingCheck() = default;
+
+  void OnRequestURLResult(brave_shields::AdBlockRequestInfo result) {
+    DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+    if (IsBlocked(result)) {
+      Finish(std::move(result));
+      return;
+    }
+    request_url_result_ = std::move(result);
+    MaybeMatchCanonicalURL();
+  }
+
+  void MaybeMatchCanonicalURL() {
+    if (finished_ || !resolved_ || !request_url_result_)
+      return;
+    if (!ctx_->initiator_url.is_valid() ||
+        GetCanonicalURL(ctx_->request_url, canonical_name_).is_empty()) {
+      Finish(std::move(*request_url_result_));
+      return;
+    }
+    PendingAdBlockCheck check(
+        ctx_, canonical_name_,
+        base::BindOnce(&CnameUncloakingCheck::Finish, this));
+    check.request_url_result = std::move(request_url_result_);
+    AdBlockCheckBatcher::GetInstance()->Add(task_runner_, std::move(check));
+  }
+
+  void Finish(brave_shields::AdBlockRequestInfo result) {
+    finished_ = true;
+    OnShouldBlockAdResult(next_callback_, ctx_, std::move(result));
+  }
+
+  ResponseCallback next_callback_;
+  scoped_refptr<base::SequencedTaskRunner> task_runner_;
+  std::shared_ptr<BraveRequestInfo> ctx_;
+  base::Optional<brave_shields::AdBlockRequestInfo> request_url_result_;
+  base::Optional<std::string> canonical_name_;
+  bool resolved_ = false;
+  bool finished_ = false;
+
+  DISALLOW_COPY_AND_ASSIGN(CnameUncloakingCheck);
+};
+
+}  // namespace
+
+void MatchCanonicalURLs(
+    const AdBlockRequestsMatcher& matcher,
+    const std::vector<base::Optional<std::string>>& canonical_names,
+    std::vector<brave_shields::AdBlockRequestInfo>* requests) {
+  DCHECK_EQ(canonical_names.size(), requests->size());
+  std::vector<brave_shields::AdBlockRequestInfo> cname_requests;
+  std::vector<size_t> cname_request_indices;
+  for (size_t i = 0; i < requests->size(); ++i) {
+    const brave_shields::AdBlockRequestInfo& request = (*requests)[i];
+    if (request.did_match_important)
+      continue;
+    const GURL canonical_url = GetCanonicalURL(request.url, canonical_names[i]);
+    if (canonical_url.is_empty())
+      continue;
+    cname_requests.push_back(request);
+    cname_requests.back().url = canonical_url;
+    cname_request_indices.push_back(i);
+  }
+  if (cname_requests.empty())
+    return;
+
+  matcher.Run(cname_requests);
+  for (size_t i = 0; i < cname_requests.size(); ++i) {
+    brave_shields::AdBlockRequestInfo& request =
+        (*requests)[cname_request_indices[i]];
+    GURL request_url = std::move(request.url);
+    request = std::move(cname_requests[i]);
+    request.url = std::move(request_url);
+  }
+}
+
 void ShouldBlockAdWithOptionalCname(
     scoped_refptr<base::SequencedTaskRunner> task_runner,
     const ResponseCallback& next_callback,
     std::shared_ptr<BraveRequestInfo> ctx,
     const base::Optional<std::string> cname) {
   DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
-  task_runner->PostTaskAndReply(
-      FROM_HERE, base::BindOnce(&ShouldBlockAdOnTaskRunner, ctx, cname),
-      base::BindOnce(&OnShouldBlockAdResult, next_callback, ctx));
+  AdBlockCheckBatcher::GetInstance()->Add(
+      task_runner,
+      PendingAdBlockCheck(
+          ctx, cname,
+          base::BindOnce(&OnShouldBlockAdResult, next_callback, ctx)));
 }
 
 class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
@@ -117,15 +341,20 @@ class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
   mojo::Receiver<network::mojom::ResolveHostClient> receiver_{this};
   base::OnceCallback<void(base::Optional<std::string>)> cb_;
   base::TimeTicks start_time_;
+  base::WeakPtr<AdBlockCnameCache> cname_cache_;
+  net::NetworkIsolationKey network_isolation_key_;
+  std::string host_;
 
  public:
   AdblockCnameResolveHostClient(
-      const ResponseCallback& next_callback,
-      scoped_refptr<base::SequencedTaskRunner> task_runner,
-      std::shared_ptr<BraveRequestInfo> ctx) {
-    cb_ = base::BindOnce(&ShouldBlockAdWithOptionalCname, task_runner,
-                         std::move(next_callback), ctx);
-
+      base::OnceCallback<void(base::Optional<std::string>)> cb,
+      std::shared_ptr<BraveRequestInfo> ctx)
+      : cb_(std::move(cb)),
+        cname_cache_(
+            AdBlockCnameCache::FromBrowserContext(ctx->browser_context)
+                ->AsWeakPtr()),
+        network_isolation_key_(ctx->network_isolation_key),
+        host_(ctx->request_url.host()) {
     auto* web_contents = GetWebContents(
         ctx->render_process_id, ctx->render_frame_id, ctx->frame_tree_node_id);
     if (!web_contents) {
@@ -136,8 +365,6 @@ class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
 
     content::BrowserContext* context = web_contents->GetBrowserContext();
 
-    const auto network_isolation_key = ctx->network_isolation_key;
-
     network::mojom::ResolveHostParametersPtr optional_parameters =
         network::mojom::ResolveHostParameters::New();
     optional_parameters->include_canonical_name = true;
@@ -153,7 +380,7 @@ class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
     start_time_ = base::TimeTicks::Now();
 
     network_context->ResolveHost(
-        net::HostPortPair::FromURL(ctx->request_url), network_isolation_key,
+        net::HostPortPair::FromURL(ctx->request_url), network_isolation_key_,
         std::move(optional_parameters), receiver_.BindNewPipeAndPassRemote());
 
     receiver_.set_disconnect_handler(
@@ -170,8 +397,11 @@ class AdblockCnameResolveHostClient : public network::mojom::ResolveHostClient {
                         base::TimeTicks::Now() - start_time_);
     if (result == net::OK && resolved_addresses) {
       DCHECK(resolved_addresses.has_value() && !resolved_addresses->empty());
-      std::move(cb_).Run(
-          base::Optional<std::string>(resolved_addresses->GetCanonicalName()));
+      const std::string& canonical_name =
+          resolved_addresses->GetCanonicalName();
+      if (cname_cache_)
+        cname_cache_->Put(network_isolation_key_, host_, canonical_name);
+      std::move(cb_).Run(base::Optional<std::string>(canonical_name));
     } else {
       std::move(cb_).Run(base::nullopt);
     }
@@ -210,10 +440,23 @@ void OnBeforeURLRequestAdBlockTP(const ResponseCallback& next_callback,
   if (ctx->browser_context->IsTor()) {
     ShouldBlockAdWithOptionalCname(task_runner, std::move(next_callback), ctx,
                                    base::nullopt);
-  } else {
-    new AdblockCnameResolveHostClient(std::move(next_callback), task_runner,
-                                      ctx);
+    return;
+  }
+
+  std::string canonical_name;
+  if (AdBlockCnameCache::FromBrowserContext(ctx->browser_context)
+          ->Get(ctx->network_isolation_key, ctx->request_url.host(),
+                &canonical_name)) {
+    ShouldBlockAdWithOptionalCname(task_runner, std::move(next_callback), ctx,
+                                   canonical_name);
+    return;
   }
+
+  auto check = base::MakeRefCounted<CnameUncloakingCheck>(
+      std::move(next_callback), task_runner, ctx);
+  check->Start();
+  new AdblockCnameResolveHostClient(
+      base::BindOnce(&CnameUncloakingCheck::OnCanonicalName, check), ctx);
 }
 
 int OnBeforeURLRequest_AdBlockTPPreWork(const ResponseCallback& next_callback,
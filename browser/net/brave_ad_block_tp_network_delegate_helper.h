@@ -7,11 +7,28 @@
 #define BRAVE_BROWSER_NET_BRAVE_AD_BLOCK_TP_NETWORK_DELEGATE_HELPER_H_
 
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "base/callback.h"
+#include "base/containers/span.h"
+#include "base/optional.h"
 #include "brave/browser/net/url_context.h"
+#include "brave/components/brave_shields/browser/ad_block_base_service.h"
 
 namespace brave {
 
+using AdBlockRequestsMatcher = base::RepeatingCallback<void(
+    base::span<brave_shields::AdBlockRequestInfo>)>;
+
+// Matches the canonical URLs of |requests|, whose hosts resolve to
+// |canonical_names|, with |matcher|. The match continues from the result for
+// the request URL, so that exceptions and important rules carry over.
+void MatchCanonicalURLs(
+    const AdBlockRequestsMatcher& matcher,
+    const std::vector<base::Optional<std::string>>& canonical_names,
+    std::vector<brave_shields::AdBlockRequestInfo>* requests);
+
 int OnBeforeURLRequest_AdBlockTPPreWork(
     const ResponseCallback& next_callback,
     std::shared_ptr<BraveRequestInfo> ctx);
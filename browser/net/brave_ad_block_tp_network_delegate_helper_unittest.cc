@@ -9,12 +9,32 @@
 #include <string>
 #include <vector>
 
+#include "base/bind.h"
+#include "base/optional.h"
 #include "brave/browser/net/url_context.h"
 #include "brave/common/network_constants.h"
+#include "brave/components/brave_shields/browser/ad_block_base_service.h"
 #include "net/base/net_errors.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 using brave::ResponseCallback;
+using brave_shields::AdBlockRequestInfo;
+
+namespace {
+
+// Stands in for an engine with the rule ||tracker.net^ and the exception
+// @@||tracker.net/allowed/.
+void MatchTrackerNet(base::span<AdBlockRequestInfo> requests) {
+  for (auto& request : requests) {
+    if (request.url.host() != "tracker.net")
+      continue;
+    request.did_match_rule = true;
+    if (request.url.path() == "/allowed/pixel.gif")
+      request.did_match_exception = true;
+  }
+}
+
+}  // namespace
 
 TEST(BraveAdBlockTPNetworkDelegateHelperTest, NoChangeURL) {
   const GURL url("https://bradhatesprimes.brave.com/composite_numbers_ftw");
@@ -32,3 +52,34 @@ TEST(BraveAdBlockTPNetworkDelegateHelperTest, EmptyRequestURL) {
   EXPECT_TRUE(request_info->new_url_spec.empty());
   EXPECT_EQ(rc, net::OK);
 }
+
+TEST(BraveAdBlockTPNetworkDelegateHelperTest, BlocksCnameUncloakedHost) {
+  std::vector<AdBlockRequestInfo> requests;
+  requests.emplace_back(GURL("https://metrics.a.com/pixel.gif"),
+                        blink::mojom::ResourceType::kImage, "a.com");
+  requests.emplace_back(GURL("https://cdn.a.com/pixel.gif"),
+                        blink::mojom::ResourceType::kImage, "a.com");
+  requests.emplace_back(GURL("https://metrics.a.com/allowed/pixel.gif"),
+                        blink::mojom::ResourceType::kImage, "a.com");
+  requests.emplace_back(GURL("https://tracker.net/pixel.gif"),
+                        blink::mojom::ResourceType::kImage, "a.com");
+  // The request URL of the last one matched an exception already.
+  requests.back().did_match_exception = true;
+  const std::vector<base::Optional<std::string>> canonical_names = {
+      std::string("tracker.net"), base::nullopt, std::string("tracker.net"),
+      std::string("tracker.net")};
+
+  brave::MatchCanonicalURLs(base::BindRepeating(&MatchTrackerNet),
+                            canonical_names, &requests);
+
+  EXPECT_TRUE(requests[0].did_match_rule);
+  EXPECT_FALSE(requests[0].did_match_exception);
+  // The result is reported for the request URL, not the canonical one.
+  EXPECT_EQ(GURL("https://metrics.a.com/pixel.gif"), requests[0].url);
+  EXPECT_FALSE(requests[1].did_match_rule);
+  EXPECT_TRUE(requests[2].did_match_rule);
+  EXPECT_TRUE(requests[2].did_match_exception);
+  // Not matched again since the CNAME doesn't point elsewhere.
+  EXPECT_FALSE(requests[3].did_match_rule);
+  EXPECT_TRUE(requests[3].did_match_exception);
+}
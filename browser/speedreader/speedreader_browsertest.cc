@@ -5,6 +5,7 @@
 
 #include "base/bind.h"
 #include "base/path_service.h"
+#include "base/test/metrics/histogram_tester.h"
 #include "brave/app/brave_command_ids.h"
 #include "brave/common/brave_paths.h"
 #include "brave/components/speedreader/features.h"
@@ -30,6 +31,12 @@ constexpr char kSpeedreaderToggleUMAHistogramName[] =
 constexpr char kSpeedreaderEnabledUMAHistogramName[] =
     "Brave.SpeedReader.Enabled";
 
+constexpr char kSpeedreaderDistillHistogramName[] =
+    "Brave.Speedreader.Distill";
+
+constexpr char kSpeedreaderBodyReadyTimeHistogramName[] =
+    "Brave.Speedreader.BodyReadyTime";
+
 class SpeedReaderBrowserTest : public InProcessBrowserTest {
  public:
   SpeedReaderBrowserTest()
@@ -110,3 +117,16 @@ IN_PROC_BROWSER_TEST_F(SpeedReaderBrowserTest, P3ATest) {
   tester.ExpectBucketCount(kSpeedreaderToggleUMAHistogramName, 1, 1);
   tester.ExpectBucketCount(kSpeedreaderToggleUMAHistogramName, 2, 0);
 }
+
+IN_PROC_BROWSER_TEST_F(SpeedReaderBrowserTest, DistillMetrics) {
+  base::HistogramTester tester;
+
+  chrome::ExecuteCommand(browser(), IDC_TOGGLE_SPEEDREADER);
+  const GURL url = https_server_.GetURL(kTestHost, kTestPage);
+  ui_test_utils::NavigateToURL(browser(), url);
+
+  // The page is distilled once and the time until the distilled body is sent
+  // is recorded along with the distilling time.
+  tester.ExpectTotalCount(kSpeedreaderDistillHistogramName, 1);
+  tester.ExpectTotalCount(kSpeedreaderBodyReadyTimeHistogramName, 1);
+}
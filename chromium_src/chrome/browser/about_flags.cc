@@ -20,6 +20,7 @@
 #include "components/prefs/pref_service.h"
 #include "net/base/features.h"
 
+using brave_shields::features::kBraveAdblockCombinedEngine;
 using brave_shields::features::kBraveAdblockCosmeticFiltering;
 using ntp_background_images::features::kBraveNTPBrandedWallpaper;
 using ntp_background_images::features::kBraveNTPBrandedWallpaperDemo;
@@ -95,6 +96,10 @@ using ntp_background_images::features::kBraveNTPSuperReferralWallpaper;
      flag_descriptions::kBraveAdblockCosmeticFilteringName,                \
      flag_descriptions::kBraveAdblockCosmeticFilteringDescription, kOsAll, \
      FEATURE_VALUE_TYPE(kBraveAdblockCosmeticFiltering)},                  \
+    {"brave-adblock-combined-engine",                                      \
+     flag_descriptions::kBraveAdblockCombinedEngineName,                   \
+     flag_descriptions::kBraveAdblockCombinedEngineDescription, kOsAll,    \
+     FEATURE_VALUE_TYPE(kBraveAdblockCombinedEngine)},                     \
     SPEEDREADER_FEATURE_ENTRIES                                            \
     BRAVE_SYNC_FEATURE_ENTRIES                                             \
     BRAVE_IPFS_FEATURE_ENTRIES                                             \
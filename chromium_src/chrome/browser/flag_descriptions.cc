@@ -24,6 +24,11 @@ const char kBraveNTPBrandedWallpaperDemoDescription[] =
 const char kBraveAdblockCosmeticFilteringName[] = "Enable cosmetic filtering";
 const char kBraveAdblockCosmeticFilteringDescription[] =
     "Enable support for cosmetic filtering";
+const char kBraveAdblockCombinedEngineName[] =
+    "Enable combined ad block engine";
+const char kBraveAdblockCombinedEngineDescription[] =
+    "Match network requests against a single engine built from the default, "
+    "regional and custom filter lists";
 const char kBraveSidebarName[] = "Enable Sidebar";
 // TODO(simon): Use more better description.
 const char kBraveSidebarDescription[] = "Enable Sidebar";
@@ -11,12 +11,34 @@
 #include <utility>
 
 #include "base/logging.h"
+#include "base/no_destructor.h"
+#include "base/strings/string_util.h"
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_parameters.h"
 
 namespace brave_perf_predictor {
 
 namespace {
 
+constexpr char kThirdPartyFeaturePrefix[] = "thirdParties.";
+constexpr char kThirdPartyFeatureSuffix[] = ".blocked";
+
+// Keys point into |feature_sequence|, which outlives the map.
+base::flat_map<base::StringPiece, size_t>
+BuildThirdPartyBlockedFeatureIndexes() {
+  std::vector<std::pair<base::StringPiece, size_t>> indexes;
+  for (size_t i = kFirstThirdPartyBlocked; i < feature_count; i++) {
+    base::StringPiece feature(feature_sequence.at(i));
+    DCHECK(base::StartsWith(feature, kThirdPartyFeaturePrefix,
+                            base::CompareCase::SENSITIVE));
+    DCHECK(base::EndsWith(feature, kThirdPartyFeatureSuffix,
+                          base::CompareCase::SENSITIVE));
+    feature.remove_prefix(sizeof(kThirdPartyFeaturePrefix) - 1);
+    feature.remove_suffix(sizeof(kThirdPartyFeatureSuffix) - 1);
+    indexes.emplace_back(feature, i);
+  }
+  return base::flat_map<base::StringPiece, size_t>(std::move(indexes));
+}
+
 bool StandardiseFeatsNoOutliers(
     std::array<double, standardise_feat_count>* features,
     const std::array<double, standardise_feat_count>& means,
@@ -65,6 +87,16 @@ double LinregPredictVector(const std::array<double, feature_count>& features) {
   return std::pow(10, log_prediction);
 }
 
+base::Optional<size_t> GetThirdPartyBlockedFeatureIndex(
+    const base::StringPiece third_party_name) {
+  static const base::NoDestructor<base::flat_map<base::StringPiece, size_t>>
+      indexes(BuildThirdPartyBlockedFeatureIndexes());
+  const auto it = indexes->find(third_party_name);
+  if (it == indexes->end())
+    return base::nullopt;
+  return it->second;
+}
+
 double LinregPredictNamed(const base::flat_map<std::string, double>& features) {
   std::array<double, feature_count> feature_vector{};
   for (unsigned int i = 0; i < feature_count; i++) {
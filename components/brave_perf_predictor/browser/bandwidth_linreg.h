@@ -6,10 +6,14 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_BANDWIDTH_LINREG_H_
 #define BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_BANDWIDTH_LINREG_H_
 
+#include <stddef.h>
+
 #include <string>
 #include <vector>
 
 #include "base/containers/flat_map.h"
+#include "base/optional.h"
+#include "base/strings/string_piece.h"
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_parameters.h"
 
 namespace brave_perf_predictor {
@@ -18,6 +22,44 @@ constexpr double kOutlierThreshold = 6;
 // if above 20MB _and_ more than 6x of the transfer size, probably an outlier
 constexpr double kSavingsAbsoluteOutlier = 20 << 20;
 
+// Indexes of the page level features in |feature_sequence|, which are followed
+// by one ".blocked" feature per relevant third party. Must match the layout of
+// bandwidth_linreg_parameters.h.
+enum FeatureIndex : size_t {
+  kAdblockRequests = 0,
+  kFirstMeaningfulPaint,
+  kObservedDomContentLoaded,
+  kObservedFirstVisualChange,
+  kObservedLoad,
+  kDocumentRequestCount,
+  kDocumentSize,
+  kFontRequestCount,
+  kFontSize,
+  kImageRequestCount,
+  kImageSize,
+  kMediaRequestCount,
+  kMediaSize,
+  kOtherRequestCount,
+  kOtherSize,
+  kScriptRequestCount,
+  kScriptSize,
+  kStylesheetRequestCount,
+  kStylesheetSize,
+  kThirdPartyRequestCount,
+  kThirdPartySize,
+  kTotalRequestCount,
+  kTotalSize,
+  kFirstThirdPartyBlocked
+};
+
+static_assert(kFirstThirdPartyBlocked == standardise_feat_count,
+              "Page level features must be the standardised features");
+
+// Returns the index of the ".blocked" feature for the third party named
+// |third_party_name|, if the model uses it.
+base::Optional<size_t> GetThirdPartyBlockedFeatureIndex(
+    const base::StringPiece third_party_name);
+
 // Computes prediction based on the provided feature vector.
 // It is the client's responsibility to provide features in
 // the exact order expected by the predictor.
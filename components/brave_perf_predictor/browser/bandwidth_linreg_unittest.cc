@@ -5,6 +5,8 @@
 
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg.h"
 
+#include <string>
+
 #include "base/containers/flat_map.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
@@ -104,4 +106,55 @@ TEST(BraveSavingsPredictorTest, HandesSpecificFeaturemapExample) {
             794);  // Equal on the order of thousands
 }
 
+TEST(BraveSavingsPredictorTest, FeatureIndexesMatchFeatureSequence) {
+  EXPECT_EQ(feature_sequence.at(kAdblockRequests), "adblockRequests");
+  EXPECT_EQ(feature_sequence.at(kFirstMeaningfulPaint),
+            "metrics.firstMeaningfulPaint");
+  EXPECT_EQ(feature_sequence.at(kObservedDomContentLoaded),
+            "metrics.observedDomContentLoaded");
+  EXPECT_EQ(feature_sequence.at(kObservedFirstVisualChange),
+            "metrics.observedFirstVisualChange");
+  EXPECT_EQ(feature_sequence.at(kObservedLoad), "metrics.observedLoad");
+  EXPECT_EQ(feature_sequence.at(kDocumentRequestCount),
+            "resources.document.requestCount");
+  EXPECT_EQ(feature_sequence.at(kDocumentSize), "resources.document.size");
+  EXPECT_EQ(feature_sequence.at(kFontRequestCount),
+            "resources.font.requestCount");
+  EXPECT_EQ(feature_sequence.at(kFontSize), "resources.font.size");
+  EXPECT_EQ(feature_sequence.at(kImageRequestCount),
+            "resources.image.requestCount");
+  EXPECT_EQ(feature_sequence.at(kImageSize), "resources.image.size");
+  EXPECT_EQ(feature_sequence.at(kMediaRequestCount),
+            "resources.media.requestCount");
+  EXPECT_EQ(feature_sequence.at(kMediaSize), "resources.media.size");
+  EXPECT_EQ(feature_sequence.at(kOtherRequestCount),
+            "resources.other.requestCount");
+  EXPECT_EQ(feature_sequence.at(kOtherSize), "resources.other.size");
+  EXPECT_EQ(feature_sequence.at(kScriptRequestCount),
+            "resources.script.requestCount");
+  EXPECT_EQ(feature_sequence.at(kScriptSize), "resources.script.size");
+  EXPECT_EQ(feature_sequence.at(kStylesheetRequestCount),
+            "resources.stylesheet.requestCount");
+  EXPECT_EQ(feature_sequence.at(kStylesheetSize), "resources.stylesheet.size");
+  EXPECT_EQ(feature_sequence.at(kThirdPartyRequestCount),
+            "resources.third-party.requestCount");
+  EXPECT_EQ(feature_sequence.at(kThirdPartySize),
+            "resources.third-party.size");
+  EXPECT_EQ(feature_sequence.at(kTotalRequestCount),
+            "resources.total.requestCount");
+  EXPECT_EQ(feature_sequence.at(kTotalSize), "resources.total.size");
+}
+
+TEST(BraveSavingsPredictorTest, ThirdPartyBlockedFeatureIndex) {
+  for (size_t i = kFirstThirdPartyBlocked; i < feature_count; i++) {
+    const std::string& feature = feature_sequence.at(i);
+    const std::string prefix = "thirdParties.";
+    const std::string suffix = ".blocked";
+    const std::string name = feature.substr(
+        prefix.length(), feature.length() - prefix.length() - suffix.length());
+    EXPECT_EQ(GetThirdPartyBlockedFeatureIndex(name), i) << feature;
+  }
+  EXPECT_FALSE(GetThirdPartyBlockedFeatureIndex("Not A Third Party"));
+}
+
 }  // namespace brave_perf_predictor
@@ -0,0 +1,1122 @@
+/* Copyright 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_NAMED_THIRD_PARTY_ENTITIES_H_
+#define BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_NAMED_THIRD_PARTY_ENTITIES_H_
+
+/* This file is automatically generated, do not edit directly */
+
+#include "brave/components/brave_perf_predictor/browser/named_third_party_registry.h"
+
+namespace brave_perf_predictor {
+
+constexpr const char* kThirdPartyEntityNames[] = {
+    "Google Analytics",
+    "Facebook",
+    "Google CDN",
+    "Google/Doubleclick Ads",
+    "Google Tag Manager",
+    "Other Google APIs/SDKs",
+    "Twitter",
+    "Yandex Metrica",
+    "jQuery CDN",
+    "AddThis",
+    "Google Maps",
+    "Hotjar",
+    "Cloudflare CDN",
+    "WordPress",
+    "Criteo",
+    "ZenDesk",
+    "Tawk.to",
+    "AMP",
+    "YouTube",
+    "Amazon Web Services",
+    "Adobe Tag Manager",
+    "JSDelivr CDN",
+    "Yandex Ads",
+    "Yandex Share",
+    "Yandex APIs",
+    "Salesforce",
+    "FontAwesome CDN",
+    "ShareThis",
+    "Mailchimp",
+    "Amazon Ads",
+    "Sentry",
+    "Pinterest",
+    "Hubspot",
+    "Taboola",
+    "Histats",
+    "Optimizely",
+    "Moat",
+    "Tealium",
+    "Scorecard Research",
+    "Wistia",
+    "LiveChat",
+    "Adobe TypeKit",
+    "OneSignal",
+    "Tumblr",
+    "Cloudflare",
+    "Integral Ad Science",
+    "PayPal",
+    "Segment",
+    "OpenX",
+    "Lucky Orange",
+    "Snapchat",
+    "Ensighten",
+    "Brightcove",
+    "Microsoft Hosted Libs",
+    "Stripe",
+    "Mixpanel",
+    "Quantcast",
+    "Pubmatic",
+    "Media.net",
+    "New Relic",
+    "Rubicon Project",
+    "VWO",
+    "Unpkg",
+    "Parse.ly",
+    "AppNexus",
+    "Yandex CDN",
+    "AOL / Oath / Verizon Media",
+    "Alexa",
+    "mPulse",
+    "Opentag",
+    "Usabilla",
+    "Po.st",
+    "Disqus",
+    "Bootstrap CDN",
+    "Media Math",
+    "LinkedIn Ads",
+    "Bing Ads",
+    "Crazy Egg",
+    "Vox Media",
+    "Concert",
+    "unpkg",
+    "The Trade Desk",
+    "Permutive",
+    "Pingdom RUM",
+    "Vimeo",
+    "Yieldify",
+    "Twitter Online Conversion Tracking",
+    "Auto Link Maker",
+    "LongTail Ad Solutions",
+    "Polldaddy",
+    "Cookie-Script.com",
+    "Amplitude Mobile Analytics",
+    "Curalate",
+    "piano",
+    "Micropat",
+    "Nielsen NetRatings SiteCensus",
+    "VigLink",
+    "Chartbeat",
+    "BrightTag / Signal",
+    "Skimbit",
+    "Rambler",
+    "Teads",
+    "Instagram",
+    "Fastly",
+    "LivePerson",
+    "Outbrain",
+    "Index Exchange",
+    "GumGum",
+    "Trust Pilot",
+    "Embedly",
+    "sovrn",
+    "iPerceptions",
+    "BlueKai",
+    "Sharethrough",
+    "Crowd Control",
+    "Gigya",
+    "JuicyAds",
+    "Mouseflow",
+    "Yahoo!",
+    "Accuweather",
+    "Evidon",
+    "Sift Science",
+    "Sortable",
+    "Affiliate Window",
+    "BounceX",
+    "ForeSee",
+    "Clicktale",
+    "Symantec",
+    "Maxymiser",
+    "Digioh",
+    "Adyoulike",
+    "eBay",
+    "Media Management Technologies",
+    "Nativo",
+    "Decibel Insight",
+    "Revcontent",
+    "Riskified",
+    "Kaltura Video Platform",
+    "TRUSTe",
+    "LoopMe",
+    "Polar Mobile Group",
+    "Sekindo",
+    "Audience 360",
+    "Monetate",
+    "SpotXchange",
+    "Tencent",
+    "Aggregate Knowledge",
+    "eXelate",
+    "FirstImpression",
+    "Cloudinary",
+    "Opta",
+    "Reevoo",
+    "Dailymotion",
+    "TripleLift",
+    "DemandBase",
+    "Ghostery Enterprise",
+    "SoundCloud",
+    "Rackspace",
+    "Playbuzz",
+    "PerimeterX Bot Defender",
+    "Marketplace Web Service",
+    "Connatix",
+    "Salesforce.com",
+    "AWeber",
+    "Unruly Media",
+    "Hola Networks",
+    "FLXone",
+    "Mobify",
+    "Apester",
+    "Pusher",
+    "Proper Media",
+    "Sailthru",
+    "Klevu Search",
+    "Trip Advisor",
+    "Captify Media",
+    "PERFORM",
+    "SpringServer",
+    "Silverpop",
+    "Polyfill service",
+    "Oracle Recommendations On Demand",
+    "Touch Commerce",
+    "Kargo",
+    "SurveyMonkey",
+    "StreamRail",
+    "Adobe Scene7",
+    "RichRelevance",
+    "Click4Assistance",
+    "Xaxis",
+    "Qualtrics",
+    "Adobe Test & Target",
+};
+
+// Sorted by domain
+constexpr ThirdPartyDomain kThirdPartyEntityByDomain[] = {
+    {"0211c83c.akstat.io", 68},
+    {"23.62.3.183", 1},
+    {"247realmedia.com", 187},
+    {"33across-d.openx.net", 48},
+    {"3lift.com", 153},
+    {"4seeresults.com", 125},
+    {"aax.amazon-adsystem.com", 29},
+    {"accuweather.com", 119},
+    {"acdn.adnxs.com", 64},
+    {"ad.doubleclick.net", 3},
+    {"ad.pxlad.io", 152},
+    {"addthiscdn.com", 9},
+    {"addthisedge.com", 9},
+    {"addtoany.com", 94},
+    {"ads.linkedin.com", 75},
+    {"ads.pubmatic.com", 57},
+    {"ads.rubiconproject.com", 60},
+    {"ads.yahoo.com", 118},
+    {"adservice.google.com", 3},
+    {"adservice.google.de", 3},
+    {"adservice.google.se", 3},
+    {"adtech.advertising.com", 66},
+    {"adyoulike.com", 130},
+    {"adyoulike.net", 130},
+    {"agkn.com", 146},
+    {"ajax.aspnetcdn.com", 53},
+    {"ajax.cloudflare.com", 44},
+    {"ajax.googleapis.com", 2},
+    {"ajax.microsoft.com", 76},
+    {"akamai.net", 1},
+    {"akamaiedge.net", 1},
+    {"akamaitechnologies.com", 1},
+    {"akamaitechnologies.fr", 1},
+    {"akamaized.net", 1},
+    {"amazonwebapps.com", 19},
+    {"amazonwebservices.com", 19},
+    {"amp.cloudflare.com", 12},
+    {"amplitude.com", 91},
+    {"an.yandex.ru", 22},
+    {"analytics.twitter.com", 86},
+    {"analytics.yahoo.com", 118},
+    {"aniview.com", 37},
+    {"answerscloud.com", 125},
+    {"aol.co.uk", 66},
+    {"aol.com", 66},
+    {"aolcdn.com", 66},
+    {"apester.com", 168},
+    {"api-cdn.amazon.com", 19},
+    {"api-maps.yandex.ru", 24},
+    {"api.segment.io", 47},
+    {"apis.google.com", 5},
+    {"assets.adobedtm.com", 20},
+    {"assets.pinterest.com", 31},
+    {"assets.tumblr.com", 43},
+    {"assets.zendesk.com", 15},
+    {"atgsvcs.com", 179},
+    {"atlassbx.com", 1},
+    {"autolinkmaker.itunes.apple.com", 87},
+    {"aweber.com", 163},
+    {"bam.nr-data.net", 59},
+    {"bat.bing.com", 76},
+    {"bat.r.msn.com", 76},
+    {"beacon.krxd.net", 25},
+    {"betrad.com", 155},
+    {"bidder.criteo.com", 14},
+    {"bkrtx.com", 112},
+    {"blogsmithmedia.com", 66},
+    {"bluekai.com", 112},
+    {"bluelithium.com", 118},
+    {"bounceexchange.com", 124},
+    {"brightcove.com", 52},
+    {"browser.sentry-cdn.com", 30},
+    {"brtstats.com", 56},
+    {"btstatic.com", 98},
+    {"c.amazon-adsystem.com", 29},
+    {"c.bing.com", 76},
+    {"c.disquscdn.com", 72},
+    {"c.go-mpulse.net", 68},
+    {"calendar.google.com", 5},
+    {"casalemedia.com", 106},
+    {"cdn-pci.optimizely.com", 35},
+    {"cdn.adsafeprotected.com", 45},
+    {"cdn.ampproject.org", 17},
+    {"cdn.concert.io", 79},
+    {"cdn.jsdelivr.net", 21},
+    {"cdn.krxd.net", 25},
+    {"cdn.livechatinc.com", 40},
+    {"cdn.mxpnl.com", 55},
+    {"cdn.onesignal.com", 42},
+    {"cdn.optimizely.com", 35},
+    {"cdn.ravenjs.com", 30},
+    {"cdn.segment.com", 47},
+    {"cdn.syndication.twimg.com", 6},
+    {"cdn.taboola.com", 33},
+    {"cdn.vox-cdn.com", 78},
+    {"cdn3.optimizely.com", 35},
+    {"cdnjs.cloudflare.com", 12},
+    {"cdnsecakmi.kaltura.com", 137},
+    {"cetrk.com", 77},
+    {"chango.com", 60},
+    {"chartbeat.com", 97},
+    {"chartbeat.net", 97},
+    {"chimpstatic.com", 28},
+    {"click4assistance.co.uk", 186},
+    {"clicktale.net", 126},
+    {"clicktalecdn.sslcs.cdngc.net", 126},
+    {"clients2.google.com", 5},
+    {"cloudinary.com", 149},
+    {"cm.g.doubleclick.net", 3},
+    {"code.jquery.com", 8},
+    {"commondatastorage.googleapis.com", 2},
+    {"connatix.com", 161},
+    {"connect.facebook.net", 1},
+    {"consent.cmp.oath.com", 66},
+    {"consumer.krxd.net", 25},
+    {"contextual.media.net", 58},
+    {"cookie-script.com", 90},
+    {"cpx.to", 174},
+    {"cquotient.com", 1},
+    {"crazyegg.com", 77},
+    {"crwdcntrl.net", 114},
+    {"cse.google.com", 5},
+    {"ct.pinterest.com", 31},
+    {"ctasnet.com", 64},
+    {"curalate.com", 92},
+    {"d10lpsik1i8c69.cloudfront.net", 49},
+    {"d116tqlcqfmz3v.cloudfront.net", 92},
+    {"d1eoo1tco6rr5e.cloudfront.net", 81},
+    {"d1z2jf7jlzjs58.cloudfront.net", 63},
+    {"d24n15hnbwhuhn.cloudfront.net", 91},
+    {"d2hlpp31teaww3.cloudfront.net", 166},
+    {"d31j93rd8oukbv.cloudfront.net", 7},
+    {"d31qbv1cthcecs.cloudfront.net", 67},
+    {"d33wq5gej88ld6.cloudfront.net", 85},
+    {"d3alqb8vzo7fun.cloudfront.net", 82},
+    {"d3c3cq33003psk.cloudfront.net", 69},
+    {"d6tizftlrpuof.cloudfront.net", 70},
+    {"decibelinsight.net", 134},
+    {"deliverimp.com", 48},
+    {"delvenetworks.com", 37},
+    {"demandbase.com", 154},
+    {"demandware.net", 1},
+    {"deployads.com", 122},
+    {"dev.visualwebsiteoptimizer.com", 61},
+    {"disqus.com", 72},
+    {"dm.gg", 152},
+    {"dmcdn.net", 152},
+    {"dnn506yrbagrg.cloudfront.net", 77},
+    {"downloads.mailchimp.com", 28},
+    {"dpm.demdex.net", 20},
+    {"dpmsrv.com", 142},
+    {"dt.adsafeprotected.com", 45},
+    {"dtm.advertising.com", 66},
+    {"dwin1.com", 123},
+    {"dwmvwp56lzq5t.cloudfront.net", 85},
+    {"ebay.com", 131},
+    {"ebayimg.com", 131},
+    {"ecx.images-amazon.com", 19},
+    {"edgefcs.net", 1},
+    {"edgekey.net", 1},
+    {"edgesuite.net", 1},
+    {"elasticbeanstalk.com", 19},
+    {"emailretargeting.com", 14},
+    {"embed.ly", 109},
+    {"embed.tawk.to", 16},
+    {"embedly.com", 109},
+    {"eu-u.openx.net", 48},
+    {"eus.rubiconproject.com", 60},
+    {"events.bouncex.net", 124},
+    {"everestads.net", 184},
+    {"everestjs.net", 184},
+    {"evidon.com", 120},
+    {"exelator.com", 147},
+    {"extended-validation-ssl.websecurity.symantec.com", 127},
+    {"f.vimeocdn.com", 84},
+    {"fast.wistia.com", 39},
+    {"fast.wistia.net", 39},
+    {"fastlane.rubiconproject.com", 60},
+    {"fastly.net", 103},
+    {"fbcdn-photos-e-a.akamaihd.net", 1},
+    {"fetchback.com", 131},
+    {"fimserve.com", 60},
+    {"firstimpression.io", 148},
+    {"fls.doubleclick.net", 3},
+    {"flx1.com", 166},
+    {"force.com", 162},
+    {"foresee.com", 125},
+    {"foreseeresults.com", 125},
+    {"forms.hubspot.com", 32},
+    {"fw.adsafeprotected.com", 45},
+    {"geo.moatads.com", 36},
+    {"geo.yahoo.com", 118},
+    {"geo.yieldifylabs.com", 85},
+    {"getsentry.com", 30},
+    {"gigya.com", 115},
+    {"gmads.net", 187},
+    {"google-analytics.com", 0},
+    {"googleads.g.doubleclick.net", 3},
+    {"gumgum.com", 107},
+    {"h-cdn.com", 165},
+    {"hellobar.com", 77},
+    {"hostingprod.com", 118},
+    {"hs-scripts.com", 32},
+    {"hscollectedforms.net", 32},
+    {"hscta.net", 32},
+    {"hsleadflows.net", 32},
+    {"hsstatic.net", 32},
+    {"hubspot.net", 32},
+    {"iasds01.com", 45},
+    {"ib.adnxs.com", 64},
+    {"image2.pubmatic.com", 57},
+    {"image4.pubmatic.com", 57},
+    {"image6.pubmatic.com", 57},
+    {"imasdk.googleapis.com", 5},
+    {"imrworldwide.com", 95},
+    {"in.hotjar.com", 11},
+    {"indexww.com", 106},
+    {"inq.com", 180},
+    {"instagram.com", 102},
+    {"iperceptions.com", 111},
+    {"js-agent.newrelic.com", 59},
+    {"js.adsrvr.org", 81},
+    {"js.hs-analytics.net", 32},
+    {"js.hsforms.net", 32},
+    {"js.leadin.com", 32},
+    {"js.stripe.com", 54},
+    {"juicyads.com", 116},
+    {"jump-time.net", 48},
+    {"jwpcdn.com", 88},
+    {"jwplatform.com", 88},
+    {"jwplayer.com", 88},
+    {"jwpltx.com", 88},
+    {"jwpsrv.com", 88},
+    {"kargo.com", 181},
+    {"klevu.com", 172},
+    {"lexity.com", 118},
+    {"lh3.googleusercontent.com", 5},
+    {"lightboxcdn.com", 129},
+    {"lijit.com", 110},
+    {"link.videoplatform.limelight.com", 37},
+    {"list-manage.com", 28},
+    {"liveperson.com", 104},
+    {"liveperson.net", 104},
+    {"logx.optimizely.com", 35},
+    {"longtailvideo.com", 88},
+    {"look.io", 104},
+    {"loopme.biz", 139},
+    {"loopme.com", 139},
+    {"loopme.me", 139},
+    {"lpsnmedia.net", 104},
+    {"luckyorange.com", 49},
+    {"luckyorange.net", 49},
+    {"m.facebook.com", 1},
+    {"m.stripe.network", 54},
+    {"maps-api-ssl.google.com", 10},
+    {"maps.google.com", 10},
+    {"maps.googleapis.com", 10},
+    {"maps.gstatic.com", 10},
+    {"match.adsrvr.org", 81},
+    {"mathads.com", 74},
+    {"mathid.mathtag.com", 74},
+    {"maxcdn.bootstrapcdn.com", 73},
+    {"maxymiser.net", 128},
+    {"mb.moatads.com", 36},
+    {"mc.yandex.ru", 7},
+    {"mediavoice.com", 140},
+    {"mighty.aol.net", 66},
+    {"mixpanel.com", 55},
+    {"mkt51.net", 177},
+    {"mkt61.net", 177},
+    {"mkt912.com", 177},
+    {"mkt922.com", 177},
+    {"mkt932.com", 177},
+    {"mkt941.com", 177},
+    {"mnet-ad.net", 58},
+    {"moatpixel.com", 36},
+    {"mobify.com", 167},
+    {"mobify.net", 167},
+    {"monetate.net", 143},
+    {"money.yandex.ru", 24},
+    {"mouseflow.com", 117},
+    {"mpstat.us", 68},
+    {"mpulse.net", 68},
+    {"msads.net", 76},
+    {"msecnd.net", 76},
+    {"mts.googleapis.com", 10},
+    {"news.google.com", 5},
+    {"nexus.ensighten.com", 51},
+    {"norton.com", 127},
+    {"npmcdn.com", 80},
+    {"ntv.io", 56},
+    {"odr.mookie1.com", 187},
+    {"omnitagjs.com", 130},
+    {"opentag-stats.qutics.com", 69},
+    {"openxadexchange.com", 48},
+    {"opta.net", 150},
+    {"outbrain.com", 105},
+    {"p.typekit.net", 41},
+    {"pagead2.googlesyndication.com", 3},
+    {"pages01.net", 177},
+    {"pages02.net", 177},
+    {"pages03.net", 177},
+    {"pages04.net", 177},
+    {"pages05.net", 177},
+    {"pangolin.blue", 166},
+    {"parsely.com", 63},
+    {"pay.google.com", 5},
+    {"payments-amazon.com", 19},
+    {"payments.google.com", 5},
+    {"paypal.com", 46},
+    {"performgroup.com", 175},
+    {"perimeterx.net", 159},
+    {"permutive.com", 82},
+    {"pinimg.com", 31},
+    {"pixel-us-east.rubiconproject.com", 60},
+    {"pixel.adsafeprotected.com", 45},
+    {"pixel.advertising.com", 66},
+    {"pixel.mathtag.com", 74},
+    {"pixel.quantserve.com", 56},
+    {"pixel.rubiconproject.com", 60},
+    {"platform-lookaside.fbsbx.com", 1},
+    {"platform.twitter.com", 6},
+    {"playbuzz.com", 158},
+    {"player.vimeo.com", 84},
+    {"players.brightcove.net", 52},
+    {"po.st", 71},
+    {"polarmobile.com", 140},
+    {"polldaddy.com", 89},
+    {"polyfill.io", 178},
+    {"postrelease.com", 133},
+    {"proper.io", 170},
+    {"pusherapp.com", 169},
+    {"px.moatads.com", 36},
+    {"pxi.pub", 159},
+    {"qmerce.com", 168},
+    {"qq.com", 145},
+    {"qualtrics.com", 188},
+    {"r.dlx.addthis.com", 9},
+    {"rackcdn.com", 157},
+    {"rackspacecloud.com", 157},
+    {"rambler.ru", 100},
+    {"raxcdn.com", 157},
+    {"redirectingat.com", 99},
+    {"reevoo.com", 151},
+    {"revcontent.com", 135},
+    {"richrelevance.com", 185},
+    {"riskified.com", 136},
+    {"rtb.openx.net", 48},
+    {"rules.quantcount.com", 56},
+    {"rum-collector-2.pingdom.net", 83},
+    {"rum-static.pingdom.net", 83},
+    {"s-msft.com", 76},
+    {"s-msn.com", 76},
+    {"s.amazon-adsystem.com", 29},
+    {"s.w.org", 13},
+    {"s.ytimg.com", 18},
+    {"s0.2mdn.net", 3},
+    {"s0.wp.com", 13},
+    {"s10.histats.com", 34},
+    {"s2.wp.com", 13},
+    {"s3.amazonaws.com", 19},
+    {"s7.addthis.com", 9},
+    {"sail-horizon.com", 171},
+    {"sail-personalize.com", 171},
+    {"sail-track.com", 171},
+    {"salesforce.com", 162},
+    {"sb.scorecardresearch.com", 38},
+    {"sc-static.net", 50},
+    {"scene7.com", 184},
+    {"scontent.cdninstagram.com", 102},
+    {"script.hotjar.com", 11},
+    {"secure-assets.rubiconproject.com", 60},
+    {"secure.adnxs.com", 64},
+    {"secure.force.com", 162},
+    {"secure.livechatinc.com", 40},
+    {"secure.quantserve.com", 56},
+    {"securepubads.g.doubleclick.net", 3},
+    {"sejs.moatads.com", 36},
+    {"sekindo.com", 141},
+    {"semantictec.com", 56},
+    {"servedbyopenx.com", 48},
+    {"service.sp.advertising.com", 66},
+    {"sharethrough.com", 113},
+    {"siftscience.com", 121},
+    {"simage2.pubmatic.com", 57},
+    {"simage4.pubmatic.com", 57},
+    {"skimresources.com", 99},
+    {"skimresources.net", 99},
+    {"snap.adsrvr.org", 81},
+    {"snap.licdn.com", 75},
+    {"soundcloud.com", 156},
+    {"speedshiftmedia.com", 132},
+    {"spotx.tv", 144},
+    {"spotxcdn.com", 144},
+    {"spotxchange.com", 144},
+    {"springserve.com", 176},
+    {"srip.net", 1},
+    {"ssl-images-amazon.com", 160},
+    {"ssl.google-analytics.com", 0},
+    {"stackpath.bootstrapcdn.com", 73},
+    {"static.ads-twitter.com", 86},
+    {"static.adsafeprotected.com", 45},
+    {"static.criteo.net", 14},
+    {"static.hotjar.com", 11},
+    {"static.tumblr.com", 43},
+    {"static.xx.fbcdn.net", 1},
+    {"static.zdassets.com", 15},
+    {"staticxx.facebook.com", 1},
+    {"stats.g.doubleclick.net", 3},
+    {"stats.pusher.com", 169},
+    {"stats.wp.com", 13},
+    {"storage.googleapis.com", 5},
+    {"stratus.sc", 156},
+    {"streamrail.com", 183},
+    {"streamrail.net", 183},
+    {"stripecdn.com", 54},
+    {"su.addthis.com", 9},
+    {"sublimevideo.net", 152},
+    {"survey.g.doubleclick.net", 3},
+    {"surveymonkey.com", 182},
+    {"symantec.com", 127},
+    {"symcb.com", 127},
+    {"symcd.com", 127},
+    {"sync-tm.everesttech.net", 20},
+    {"sync.mathtag.com", 74},
+    {"t.mookie1.com", 187},
+    {"t.sharethis.com", 27},
+    {"taboolasyndication.com", 33},
+    {"tacdn.com", 173},
+    {"tacoda.net", 66},
+    {"tag.sp.advertising.com", 66},
+    {"tags.tiqcdn.com", 37},
+    {"teads.tv", 101},
+    {"tealium.hs.llnwd.net", 37},
+    {"thebrighttag.com", 98},
+    {"tinypass.com", 93},
+    {"token.rubiconproject.com", 60},
+    {"touchcommerce.com", 180},
+    {"tpc.googlesyndication.com", 3},
+    {"tr.snapchat.com", 50},
+    {"translate.googleapis.com", 5},
+    {"trc.taboola.com", 33},
+    {"tripadvisor.co.uk", 173},
+    {"tripadvisor.com", 173},
+    {"truste.com", 138},
+    {"trustpilot.com", 108},
+    {"tt.omtrdc.net", 189},
+    {"twitpic.com", 6},
+    {"typekit.com", 41},
+    {"u.openx.net", 48},
+    {"uk-ads.openx.net", 48},
+    {"unpkg.com", 62},
+    {"unrulymedia.com", 164},
+    {"urchin.com", 0},
+    {"us-ads.openx.net", 48},
+    {"us-u.openx.net", 48},
+    {"use.fontawesome.com", 26},
+    {"use.typekit.net", 41},
+    {"usermatch.krxd.net", 25},
+    {"v2.zopim.com", 15},
+    {"v4.moatads.com", 36},
+    {"vars.hotjar.com", 11},
+    {"vc.hotjar.io", 11},
+    {"viator.com", 173},
+    {"vidstat.taboola.com", 33},
+    {"viglink.com", 96},
+    {"vine.co", 6},
+    {"visualrevenue.com", 105},
+    {"vjs.zencdn.net", 52},
+    {"vntsm.com", 139},
+    {"voxmedia.com", 78},
+    {"w.sharethis.com", 27},
+    {"w.usabilla.com", 70},
+    {"websitetestlink.com", 157},
+    {"widget.sndcdn.com", 156},
+    {"windows.net", 76},
+    {"wordpress.com", 13},
+    {"ws.amazon.co.uk", 19},
+    {"ws.sharethis.com", 27},
+    {"www.dailymotion.com", 152},
+    {"www.facebook.com", 1},
+    {"www.google-analytics.com", 0},
+    {"www.google.com", 5},
+    {"www.googleadservices.com", 3},
+    {"www.googletagmanager.com", 4},
+    {"www.googletagservices.com", 3},
+    {"www.gstatic.com", 2},
+    {"www.jscache.com", 173},
+    {"www.linkedin.com", 75},
+    {"www.npttech.com", 93},
+    {"www.paypalobjects.com", 46},
+    {"www.tamgrt.com", 173},
+    {"www.youtube.com", 18},
+    {"wwwimages.adobe.com", 184},
+    {"x.dlx.addthis.com", 9},
+    {"yahoo.net", 118},
+    {"yahooapis.com", 118},
+    {"yandex.st", 65},
+    {"yastatic.net", 23},
+    {"yieldify.com", 85},
+    {"yimg.com", 118},
+    {"youtube-nocookie.com", 18},
+    {"yt3.ggpht.com", 18},
+    {"ywxi.net", 145},
+    {"z-na.amazon-adsystem.com", 29},
+    {"z.moatads.com", 36},
+    {"zenfs.com", 118},
+};
+
+// Sorted by domain
+constexpr ThirdPartyDomain kThirdPartyEntityByRootDomain[] = {
+    {"247realmedia.com", 187},
+    {"2mdn.net", 3},
+    {"3lift.com", 153},
+    {"4seeresults.com", 125},
+    {"accuweather.com", 119},
+    {"addthis.com", 9},
+    {"addthiscdn.com", 9},
+    {"addthisedge.com", 9},
+    {"addtoany.com", 94},
+    {"adnxs.com", 64},
+    {"adobe.com", 184},
+    {"adobedtm.com", 20},
+    {"ads-twitter.com", 86},
+    {"adsafeprotected.com", 45},
+    {"adsrvr.org", 81},
+    {"advertising.com", 66},
+    {"adyoulike.com", 130},
+    {"adyoulike.net", 130},
+    {"agkn.com", 146},
+    {"ajax.googleapis.com", 2},
+    {"akamaitechnologies.com", 1},
+    {"akamaitechnologies.fr", 1},
+    {"akstat.io", 68},
+    {"amazon-adsystem.com", 29},
+    {"amazon.co.uk", 19},
+    {"amazon.com", 19},
+    {"amazonwebapps.com", 19},
+    {"amazonwebservices.com", 19},
+    {"amplitude.com", 91},
+    {"ampproject.org", 17},
+    {"aniview.com", 37},
+    {"answerscloud.com", 125},
+    {"aol.co.uk", 66},
+    {"aol.com", 66},
+    {"aol.net", 66},
+    {"aolcdn.com", 66},
+    {"apester.com", 168},
+    {"apple.com", 87},
+    {"aspnetcdn.com", 53},
+    {"atgsvcs.com", 179},
+    {"atlassbx.com", 1},
+    {"aweber.com", 163},
+    {"betrad.com", 155},
+    {"bing.com", 76},
+    {"bkrtx.com", 112},
+    {"blogsmithmedia.com", 66},
+    {"bluekai.com", 112},
+    {"bluelithium.com", 118},
+    {"bootstrapcdn.com", 73},
+    {"bounceexchange.com", 124},
+    {"bouncex.net", 124},
+    {"brightcove.com", 52},
+    {"brightcove.net", 52},
+    {"brtstats.com", 56},
+    {"btstatic.com", 98},
+    {"casalemedia.com", 106},
+    {"cdngc.net", 126},
+    {"cdninstagram.com", 102},
+    {"cetrk.com", 77},
+    {"chango.com", 60},
+    {"chartbeat.com", 97},
+    {"chartbeat.net", 97},
+    {"chimpstatic.com", 28},
+    {"click4assistance.co.uk", 186},
+    {"clicktale.net", 126},
+    {"cloudinary.com", 149},
+    {"commondatastorage.googleapis.com", 2},
+    {"concert.io", 79},
+    {"connatix.com", 161},
+    {"cookie-script.com", 90},
+    {"cpx.to", 174},
+    {"cquotient.com", 1},
+    {"crazyegg.com", 77},
+    {"criteo.com", 14},
+    {"criteo.net", 14},
+    {"crwdcntrl.net", 114},
+    {"ctasnet.com", 64},
+    {"curalate.com", 92},
+    {"d10lpsik1i8c69.cloudfront.net", 49},
+    {"d116tqlcqfmz3v.cloudfront.net", 92},
+    {"d1eoo1tco6rr5e.cloudfront.net", 81},
+    {"d1z2jf7jlzjs58.cloudfront.net", 63},
+    {"d24n15hnbwhuhn.cloudfront.net", 91},
+    {"d2hlpp31teaww3.cloudfront.net", 166},
+    {"d31j93rd8oukbv.cloudfront.net", 7},
+    {"d31qbv1cthcecs.cloudfront.net", 67},
+    {"d33wq5gej88ld6.cloudfront.net", 85},
+    {"d3alqb8vzo7fun.cloudfront.net", 82},
+    {"d3c3cq33003psk.cloudfront.net", 69},
+    {"d6tizftlrpuof.cloudfront.net", 70},
+    {"dailymotion.com", 152},
+    {"decibelinsight.net", 134},
+    {"deliverimp.com", 48},
+    {"delvenetworks.com", 37},
+    {"demandbase.com", 154},
+    {"demandware.net", 1},
+    {"demdex.net", 20},
+    {"deployads.com", 122},
+    {"disqus.com", 72},
+    {"disquscdn.com", 72},
+    {"dm.gg", 152},
+    {"dmcdn.net", 152},
+    {"dnn506yrbagrg.cloudfront.net", 77},
+    {"doubleclick.net", 3},
+    {"dpmsrv.com", 142},
+    {"dwin1.com", 123},
+    {"dwmvwp56lzq5t.cloudfront.net", 85},
+    {"ebay.com", 131},
+    {"ebayimg.com", 131},
+    {"edgefcs.net", 1},
+    {"emailretargeting.com", 14},
+    {"embed.ly", 109},
+    {"embedly.com", 109},
+    {"ensighten.com", 51},
+    {"everestads.net", 184},
+    {"everestjs.net", 184},
+    {"everesttech.net", 20},
+    {"evidon.com", 120},
+    {"exelator.com", 147},
+    {"facebook.com", 1},
+    {"facebook.net", 1},
+    {"fastly.net", 103},
+    {"fbcdn-photos-e-a.akamaihd.net", 1},
+    {"fbcdn.net", 1},
+    {"fbsbx.com", 1},
+    {"fetchback.com", 131},
+    {"fimserve.com", 60},
+    {"firstimpression.io", 148},
+    {"flx1.com", 166},
+    {"fontawesome.com", 26},
+    {"force.com", 162},
+    {"foresee.com", 125},
+    {"foreseeresults.com", 125},
+    {"getsentry.com", 30},
+    {"ggpht.com", 18},
+    {"gigya.com", 115},
+    {"gmads.net", 187},
+    {"go-mpulse.net", 68},
+    {"google-analytics.com", 0},
+    {"google.com", 10},
+    {"google.de", 3},
+    {"google.se", 3},
+    {"googleadservices.com", 3},
+    {"googlesyndication.com", 3},
+    {"googletagmanager.com", 4},
+    {"googletagservices.com", 3},
+    {"googleusercontent.com", 5},
+    {"gumgum.com", 107},
+    {"h-cdn.com", 165},
+    {"hellobar.com", 77},
+    {"histats.com", 34},
+    {"hostingprod.com", 118},
+    {"hotjar.com", 11},
+    {"hotjar.io", 11},
+    {"hs-analytics.net", 32},
+    {"hs-scripts.com", 32},
+    {"hscollectedforms.net", 32},
+    {"hscta.net", 32},
+    {"hsforms.net", 32},
+    {"hsleadflows.net", 32},
+    {"hsstatic.net", 32},
+    {"hubspot.com", 32},
+    {"hubspot.net", 32},
+    {"iasds01.com", 45},
+    {"images-amazon.com", 19},
+    {"imasdk.googleapis.com", 5},
+    {"imrworldwide.com", 95},
+    {"indexww.com", 106},
+    {"inq.com", 180},
+    {"instagram.com", 102},
+    {"iperceptions.com", 111},
+    {"jquery.com", 8},
+    {"jscache.com", 173},
+    {"jsdelivr.net", 21},
+    {"juicyads.com", 116},
+    {"jump-time.net", 48},
+    {"jwpcdn.com", 88},
+    {"jwplatform.com", 88},
+    {"jwplayer.com", 88},
+    {"jwpltx.com", 88},
+    {"jwpsrv.com", 88},
+    {"kaltura.com", 137},
+    {"kargo.com", 181},
+    {"klevu.com", 172},
+    {"krxd.net", 25},
+    {"leadin.com", 32},
+    {"lexity.com", 118},
+    {"licdn.com", 75},
+    {"lightboxcdn.com", 129},
+    {"lijit.com", 110},
+    {"limelight.com", 37},
+    {"linkedin.com", 75},
+    {"list-manage.com", 28},
+    {"livechatinc.com", 40},
+    {"liveperson.com", 104},
+    {"liveperson.net", 104},
+    {"llnwd.net", 37},
+    {"longtailvideo.com", 88},
+    {"look.io", 104},
+    {"loopme.biz", 139},
+    {"loopme.com", 139},
+    {"loopme.me", 139},
+    {"lpsnmedia.net", 104},
+    {"luckyorange.com", 49},
+    {"luckyorange.net", 49},
+    {"mailchimp.com", 28},
+    {"maps.googleapis.com", 10},
+    {"mathads.com", 74},
+    {"mathtag.com", 74},
+    {"maxymiser.net", 128},
+    {"media.net", 58},
+    {"mediavoice.com", 140},
+    {"microsoft.com", 76},
+    {"mixpanel.com", 55},
+    {"mkt51.net", 177},
+    {"mkt61.net", 177},
+    {"mkt912.com", 177},
+    {"mkt922.com", 177},
+    {"mkt932.com", 177},
+    {"mkt941.com", 177},
+    {"mnet-ad.net", 58},
+    {"moatads.com", 36},
+    {"moatpixel.com", 36},
+    {"mobify.com", 167},
+    {"mobify.net", 167},
+    {"monetate.net", 143},
+    {"mookie1.com", 187},
+    {"mouseflow.com", 117},
+    {"mpstat.us", 68},
+    {"mpulse.net", 68},
+    {"msads.net", 76},
+    {"msecnd.net", 76},
+    {"msn.com", 76},
+    {"mts.googleapis.com", 10},
+    {"mxpnl.com", 55},
+    {"newrelic.com", 59},
+    {"norton.com", 127},
+    {"npmcdn.com", 80},
+    {"npttech.com", 93},
+    {"nr-data.net", 59},
+    {"ntv.io", 56},
+    {"oath.com", 66},
+    {"omnitagjs.com", 130},
+    {"omtrdc.net", 189},
+    {"onesignal.com", 42},
+    {"openx.net", 48},
+    {"openxadexchange.com", 48},
+    {"opta.net", 150},
+    {"optimizely.com", 35},
+    {"outbrain.com", 105},
+    {"pages01.net", 177},
+    {"pages02.net", 177},
+    {"pages03.net", 177},
+    {"pages04.net", 177},
+    {"pages05.net", 177},
+    {"pangolin.blue", 166},
+    {"parsely.com", 63},
+    {"payments-amazon.com", 19},
+    {"paypal.com", 46},
+    {"paypalobjects.com", 46},
+    {"performgroup.com", 175},
+    {"perimeterx.net", 159},
+    {"permutive.com", 82},
+    {"pingdom.net", 83},
+    {"pinimg.com", 31},
+    {"pinterest.com", 31},
+    {"playbuzz.com", 158},
+    {"po.st", 71},
+    {"polarmobile.com", 140},
+    {"polldaddy.com", 89},
+    {"polyfill.io", 178},
+    {"postrelease.com", 133},
+    {"proper.io", 170},
+    {"pubmatic.com", 57},
+    {"pusher.com", 169},
+    {"pusherapp.com", 169},
+    {"pxi.pub", 159},
+    {"pxlad.io", 152},
+    {"qmerce.com", 168},
+    {"qq.com", 145},
+    {"qualtrics.com", 188},
+    {"quantcount.com", 56},
+    {"quantserve.com", 56},
+    {"qutics.com", 69},
+    {"rackcdn.com", 157},
+    {"rackspacecloud.com", 157},
+    {"rambler.ru", 100},
+    {"ravenjs.com", 30},
+    {"raxcdn.com", 157},
+    {"redirectingat.com", 99},
+    {"reevoo.com", 151},
+    {"revcontent.com", 135},
+    {"richrelevance.com", 185},
+    {"riskified.com", 136},
+    {"rubiconproject.com", 60},
+    {"s-msft.com", 76},
+    {"s-msn.com", 76},
+    {"sail-horizon.com", 171},
+    {"sail-personalize.com", 171},
+    {"sail-track.com", 171},
+    {"salesforce.com", 162},
+    {"sc-static.net", 50},
+    {"scene7.com", 184},
+    {"scorecardresearch.com", 38},
+    {"segment.com", 47},
+    {"segment.io", 47},
+    {"sekindo.com", 141},
+    {"semantictec.com", 56},
+    {"sentry-cdn.com", 30},
+    {"servedbyopenx.com", 48},
+    {"sharethis.com", 27},
+    {"sharethrough.com", 113},
+    {"siftscience.com", 121},
+    {"skimresources.com", 99},
+    {"skimresources.net", 99},
+    {"snapchat.com", 50},
+    {"sndcdn.com", 156},
+    {"soundcloud.com", 156},
+    {"speedshiftmedia.com", 132},
+    {"spotx.tv", 144},
+    {"spotxcdn.com", 144},
+    {"spotxchange.com", 144},
+    {"springserve.com", 176},
+    {"srip.net", 1},
+    {"ssl-images-amazon.com", 160},
+    {"storage.googleapis.com", 5},
+    {"stratus.sc", 156},
+    {"streamrail.com", 183},
+    {"streamrail.net", 183},
+    {"stripe.com", 54},
+    {"stripe.network", 54},
+    {"stripecdn.com", 54},
+    {"sublimevideo.net", 152},
+    {"surveymonkey.com", 182},
+    {"symantec.com", 127},
+    {"symcb.com", 127},
+    {"symcd.com", 127},
+    {"taboola.com", 33},
+    {"taboolasyndication.com", 33},
+    {"tacdn.com", 173},
+    {"tacoda.net", 66},
+    {"tamgrt.com", 173},
+    {"tawk.to", 16},
+    {"teads.tv", 101},
+    {"thebrighttag.com", 98},
+    {"tinypass.com", 93},
+    {"tiqcdn.com", 37},
+    {"touchcommerce.com", 180},
+    {"translate.googleapis.com", 5},
+    {"tripadvisor.co.uk", 173},
+    {"tripadvisor.com", 173},
+    {"truste.com", 138},
+    {"trustpilot.com", 108},
+    {"tumblr.com", 43},
+    {"twimg.com", 6},
+    {"twitpic.com", 6},
+    {"typekit.com", 41},
+    {"typekit.net", 41},
+    {"unpkg.com", 62},
+    {"unrulymedia.com", 164},
+    {"urchin.com", 0},
+    {"usabilla.com", 70},
+    {"viator.com", 173},
+    {"viglink.com", 96},
+    {"vimeo.com", 84},
+    {"vimeocdn.com", 84},
+    {"vine.co", 6},
+    {"visualrevenue.com", 105},
+    {"visualwebsiteoptimizer.com", 61},
+    {"vntsm.com", 139},
+    {"vox-cdn.com", 78},
+    {"voxmedia.com", 78},
+    {"w.org", 13},
+    {"websitetestlink.com", 157},
+    {"windows.net", 76},
+    {"wistia.com", 39},
+    {"wistia.net", 39},
+    {"wordpress.com", 13},
+    {"wp.com", 13},
+    {"yahoo.com", 118},
+    {"yahoo.net", 118},
+    {"yahooapis.com", 118},
+    {"yandex.ru", 24},
+    {"yandex.st", 65},
+    {"yastatic.net", 23},
+    {"yieldify.com", 85},
+    {"yieldifylabs.com", 85},
+    {"yimg.com", 118},
+    {"youtube-nocookie.com", 18},
+    {"youtube.com", 18},
+    {"ytimg.com", 18},
+    {"ywxi.net", 145},
+    {"zdassets.com", 15},
+    {"zencdn.net", 52},
+    {"zendesk.com", 15},
+    {"zenfs.com", 118},
+    {"zopim.com", 15},
+};
+
+}  // namespace brave_perf_predictor
+
+#endif  // BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_NAMED_THIRD_PARTY_ENTITIES_H_
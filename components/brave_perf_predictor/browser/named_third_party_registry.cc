@@ -5,41 +5,76 @@
 
 #include "brave/components/brave_perf_predictor/browser/named_third_party_registry.h"
 
-#include <tuple>
-
-#include "base/bind.h"
+#include <algorithm>
+#include <deque>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "base/containers/flat_map.h"
 #include "base/containers/flat_set.h"
 #include "base/json/json_reader.h"
 #include "base/logging.h"
-#include "base/metrics/histogram_macros.h"
-#include "base/strings/string_piece.h"
-#include "base/strings/string_util.h"
-#include "base/task/post_task.h"
-#include "base/task/thread_pool.h"
 #include "base/values.h"
 #include "brave/components/brave_perf_predictor/browser/bandwidth_linreg_parameters.h"
-#include "components/grit/brave_components_resources.h"
+#include "brave/components/brave_perf_predictor/browser/named_third_party_entities.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
-#include "ui/base/resource/resource_bundle.h"
 #include "url/gurl.h"
 
 namespace brave_perf_predictor {
 
+struct NamedThirdPartyRegistry::LoadedMappings {
+  // Owns the names and domains pointed to by the tables below. Unlike a
+  // vector, a deque doesn't move its elements when it grows.
+  std::deque<std::string> strings;
+  std::vector<const char*> entity_names;
+  std::vector<ThirdPartyDomain> entity_by_domain;
+  std::vector<ThirdPartyDomain> entity_by_root_domain;
+};
+
 namespace {
 
-std::tuple<base::flat_map<std::string, std::string>,
-           base::flat_map<std::string, std::string>>
-ParseMappings(const base::StringPiece entities, bool discard_irrelevant) {
-  base::flat_map<std::string, std::string> entity_by_domain;
-  base::flat_map<std::string, std::string> entity_by_root_domain;
+template <typename T>
+void AddDomains(const T& entity_by_domain,
+                std::deque<std::string>* strings,
+                std::vector<ThirdPartyDomain>* domains) {
+  domains->reserve(entity_by_domain.size());
+  for (const auto& entry : entity_by_domain) {
+    strings->push_back(entry.first);
+    domains->push_back({strings->back().c_str(), entry.second});
+  }
+}
+
+const ThirdPartyDomain* FindDomain(base::span<const ThirdPartyDomain> domains,
+                                   const base::StringPiece domain) {
+  const auto it = std::lower_bound(
+      domains.begin(), domains.end(), domain,
+      [](const ThirdPartyDomain& entry, const base::StringPiece domain) {
+        return base::StringPiece(entry.domain) < domain;
+      });
+  if (it == domains.end() || domain != it->domain)
+    return nullptr;
+  return &*it;
+}
+
+}  // namespace
 
+// static
+std::unique_ptr<NamedThirdPartyRegistry::LoadedMappings>
+NamedThirdPartyRegistry::ParseMappings(const base::StringPiece entities,
+                                       bool discard_irrelevant) {
   // Parse the JSON
   base::Optional<base::Value> document = base::JSONReader::Read(entities);
   if (!document || !document->is_list()) {
     LOG(ERROR) << "Cannot parse the third-party entities list";
-    return {};
+    return nullptr;
   }
 
+  auto mappings = std::make_unique<LoadedMappings>();
+  std::vector<std::pair<std::string, uint16_t>> entity_by_domain;
+  std::map<std::string, uint16_t> entity_by_root_domain;
+
   // Collect the mappings
   for (auto& entity : document->GetList()) {
     const std::string* entity_name = entity.FindStringPath("name");
@@ -53,78 +88,77 @@ ParseMappings(const base::StringPiece entities, bool discard_irrelevant) {
     if (!entity_domains)
       continue;
 
+    DCHECK_LT(mappings->entity_names.size(), UINT16_MAX);
+    const uint16_t entity_index = mappings->entity_names.size();
+    mappings->strings.push_back(*entity_name);
+    mappings->entity_names.push_back(mappings->strings.back().c_str());
+
     for (auto& entity_domain_it : entity_domains->GetList()) {
       if (!entity_domain_it.is_string()) {
         continue;
       }
       const base::StringPiece entity_domain(entity_domain_it.GetString());
 
-      const auto inserted =
-          entity_by_domain.emplace(entity_domain, *entity_name);
-      if (!inserted.second) {
-        VLOG(2) << "Malformed data: duplicate domain " << entity_domain;
-      }
-      auto root_domain = net::registry_controlled_domains::GetDomainAndRegistry(
-          entity_domain,
-          net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+      entity_by_domain.emplace_back(entity_domain.as_string(), entity_index);
+
+      const std::string root_domain =
+          net::registry_controlled_domains::GetDomainAndRegistry(
+              entity_domain,
+              net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+      if (root_domain.empty())
+        continue;
 
       auto root_entity_entry = entity_by_root_domain.find(root_domain);
       if (root_entity_entry != entity_by_root_domain.end() &&
-          root_entity_entry->second != *entity_name) {
+          *entity_name !=
+              mappings->entity_names[root_entity_entry->second]) {
         // If there is a clash at root domain level, neither is correct
         entity_by_root_domain.erase(root_entity_entry);
       } else {
-        entity_by_root_domain.emplace(root_domain, *entity_name);
+        entity_by_root_domain.emplace(root_domain, entity_index);
       }
     }
   }
 
-  entity_by_domain.shrink_to_fit();
-  entity_by_root_domain.shrink_to_fit();
-  return std::make_tuple(entity_by_domain, entity_by_root_domain);
-}
+  // Sort once rather than inserting into a flat_map domain by domain. The
+  // first entity listing a domain wins.
+  const size_t domain_count = entity_by_domain.size();
+  const base::flat_map<std::string, uint16_t> unique_entity_by_domain(
+      std::move(entity_by_domain));
+  if (unique_entity_by_domain.size() != domain_count) {
+    VLOG(2) << "Malformed data: "
+            << domain_count - unique_entity_by_domain.size()
+            << " duplicate domains";
+  }
 
-std::tuple<base::flat_map<std::string, std::string>,
-           base::flat_map<std::string, std::string>>
-ParseFromResource(int resource_id) {
-  // TODO(AndriusA): insert trace event here
-  SCOPED_UMA_HISTOGRAM_TIMER(
-      "Brave.Savings.NamedThirdPartyRegistry.LoadTimeMS");
-  auto& resource_bundle = ui::ResourceBundle::GetSharedInstance();
-  std::string data_resource =
-      resource_bundle.LoadDataResourceString(resource_id);
-  // Parse resource, discarding irrelevant entities
-  return ParseMappings(data_resource, true);
+  AddDomains(unique_entity_by_domain, &mappings->strings,
+             &mappings->entity_by_domain);
+  AddDomains(entity_by_root_domain, &mappings->strings,
+             &mappings->entity_by_root_domain);
+  return mappings;
 }
 
-}  // namespace
-
 bool NamedThirdPartyRegistry::LoadMappings(const base::StringPiece entities,
                                            bool discard_irrelevant) {
   // Reset previous mappings
-  entity_by_domain_.clear();
-  entity_by_root_domain_.clear();
+  entity_names_ = {};
+  entity_by_domain_ = {};
+  entity_by_root_domain_ = {};
   initialized_ = false;
 
-  tie(entity_by_domain_, entity_by_root_domain_) =
-      ParseMappings(entities, discard_irrelevant);
-  if (entity_by_domain_.size() == 0 || entity_by_root_domain_.size() == 0)
+  loaded_mappings_ = ParseMappings(entities, discard_irrelevant);
+  if (!loaded_mappings_ || loaded_mappings_->entity_by_domain.empty() ||
+      loaded_mappings_->entity_by_root_domain.empty())
     return false;
 
+  entity_names_ = loaded_mappings_->entity_names;
+  entity_by_domain_ = loaded_mappings_->entity_by_domain;
+  entity_by_root_domain_ = loaded_mappings_->entity_by_root_domain;
   initialized_ = true;
   return true;
 }
 
-void NamedThirdPartyRegistry::UpdateMappings(
-    std::tuple<base::flat_map<std::string, std::string>,
-               base::flat_map<std::string, std::string>> entity_mappings) {
-  tie(entity_by_domain_, entity_by_root_domain_) = entity_mappings;
-  VLOG(2) << "Loaded " << entity_by_domain_.size() << " mappings by domain and "
-          << entity_by_root_domain_.size() << " by root domain; size";
-  initialized_ = true;
-}
-
-base::Optional<std::string> NamedThirdPartyRegistry::GetThirdParty(
+base::Optional<base::StringPiece> NamedThirdPartyRegistry::GetThirdParty(
     const base::StringPiece request_url) const {
   if (!IsInitialized()) {
     VLOG(2) << "Named Third Party Registry not initialized";
@@ -132,21 +166,39 @@ base::Optional<std::string> NamedThirdPartyRegistry::GetThirdParty(
   }
 
   const GURL url(request_url);
-  if (!url.is_valid())
+  if (!url.is_valid() || !url.has_host())
     return base::nullopt;
 
-  if (url.has_host()) {
-    auto domain_entry = entity_by_domain_.find(url.host());
-    if (domain_entry != entity_by_domain_.end())
-      return domain_entry->second;
-
-    auto root_domain = net::registry_controlled_domains::GetDomainAndRegistry(
-        url, net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+  return GetThirdPartyForHost(url.host_piece());
+}
 
-    auto root_domain_entry = entity_by_root_domain_.find(root_domain);
-    if (root_domain_entry != entity_by_root_domain_.end())
-      return root_domain_entry->second;
+base::Optional<base::StringPiece> NamedThirdPartyRegistry::GetThirdPartyForHost(
+    const base::StringPiece host) const {
+  const ThirdPartyDomain* domain_entry = FindDomain(entity_by_domain_, host);
+  if (domain_entry)
+    return base::StringPiece(entity_names_[domain_entry->entity]);
+
+  // Only the registrable domain of |host| is looked up by root domain. A
+  // shorter listed suffix, e.g. fastly.net for x.freetls.fastly.net, belongs
+  // to a different site when the host is under a private registry. |host| is
+  // canonical, so the domain is sliced out of it without a copy.
+  const size_t registry_length =
+      net::registry_controlled_domains::GetCanonicalHostRegistryLength(
+          host, net::registry_controlled_domains::EXCLUDE_UNKNOWN_REGISTRIES,
+          net::registry_controlled_domains::INCLUDE_PRIVATE_REGISTRIES);
+  if (registry_length == std::string::npos || registry_length == 0 ||
+      registry_length >= host.length() - 1) {
+    return base::nullopt;
   }
+  // Step back over the registry and its dot to the label before it.
+  const size_t dot = host.rfind('.', host.length() - registry_length - 2);
+  const base::StringPiece root_domain =
+      dot == base::StringPiece::npos ? host : host.substr(dot + 1);
+
+  const ThirdPartyDomain* root_domain_entry =
+      FindDomain(entity_by_root_domain_, root_domain);
+  if (root_domain_entry)
+    return base::StringPiece(entity_names_[root_domain_entry->entity]);
 
   return base::nullopt;
 }
@@ -156,11 +208,11 @@ NamedThirdPartyRegistry::NamedThirdPartyRegistry() = default;
 NamedThirdPartyRegistry::~NamedThirdPartyRegistry() = default;
 
 void NamedThirdPartyRegistry::InitializeDefault() {
-  base::PostTaskAndReplyWithResult(
-      FROM_HERE, {base::ThreadPool(), base::MayBlock()},
-      base::BindOnce(&ParseFromResource, IDR_THIRD_PARTY_ENTITIES),
-      base::BindOnce(&NamedThirdPartyRegistry::UpdateMappings,
-                     weak_factory_.GetWeakPtr()));
+  loaded_mappings_.reset();
+  entity_names_ = kThirdPartyEntityNames;
+  entity_by_domain_ = kThirdPartyEntityByDomain;
+  entity_by_root_domain_ = kThirdPartyEntityByRootDomain;
+  initialized_ = true;
 }
 
 }  // namespace brave_perf_predictor
@@ -6,16 +6,23 @@
 #ifndef BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_NAMED_THIRD_PARTY_REGISTRY_H_
 #define BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_NAMED_THIRD_PARTY_REGISTRY_H_
 
-#include <string>
-#include <tuple>
+#include <stdint.h>
 
-#include "base/containers/flat_map.h"
-#include "base/memory/weak_ptr.h"
-#include "base/values.h"
+#include <memory>
+
+#include "base/containers/span.h"
+#include "base/optional.h"
+#include "base/strings/string_piece.h"
 #include "components/keyed_service/core/keyed_service.h"
 
 namespace brave_perf_predictor {
 
+// A domain mapped to the index of its entity in the list of entity names.
+struct ThirdPartyDomain {
+  const char* domain;
+  uint16_t entity;
+};
+
 // Retrieves publicly known Third Party (organisation) for a given URL, using
 // data from the Third Party Web repository
 // (https://github.com/patrickhulce/third-party-web).
@@ -31,23 +38,32 @@ class NamedThirdPartyRegistry : public KeyedService {
   // entities not relevant to the bandwith prediction model (i.e. those not
   // seen in training the model).
   bool LoadMappings(const base::StringPiece entities, bool discard_irrelevant);
-  // Default initialization - asynchronously load from bundled resource
+  // Default initialization - use the mappings of the bundled entities list
+  // prebuilt by python/export_third_parties.py
   void InitializeDefault();
-  base::Optional<std::string> GetThirdParty(
-      const base::StringPiece domain) const;
+  // The returned name is valid until the mappings are reloaded or the registry
+  // is destroyed.
+  base::Optional<base::StringPiece> GetThirdParty(
+      const base::StringPiece request_url) const;
 
  private:
+  struct LoadedMappings;
+
+  static std::unique_ptr<LoadedMappings> ParseMappings(
+      const base::StringPiece entities,
+      bool discard_irrelevant);
+
   bool IsInitialized() const { return initialized_; }
-  void MarkInitialized(bool initialized) { initialized_ = initialized; }
-  void UpdateMappings(
-      std::tuple<base::flat_map<std::string, std::string>,
-                 base::flat_map<std::string, std::string>> entity_mappings);
+  base::Optional<base::StringPiece> GetThirdPartyForHost(
+      const base::StringPiece host) const;
 
   bool initialized_ = false;
-  base::flat_map<std::string, std::string> entity_by_domain_;
-  base::flat_map<std::string, std::string> entity_by_root_domain_;
-
-  base::WeakPtrFactory<NamedThirdPartyRegistry> weak_factory_{this};
+  // Either the prebuilt mappings or those owned by |loaded_mappings_|. Domains
+  // are sorted so they can be binary searched.
+  base::span<const char* const> entity_names_;
+  base::span<const ThirdPartyDomain> entity_by_domain_;
+  base::span<const ThirdPartyDomain> entity_by_root_domain_;
+  std::unique_ptr<LoadedMappings> loaded_mappings_;
 };
 
 }  // namespace brave_perf_predictor
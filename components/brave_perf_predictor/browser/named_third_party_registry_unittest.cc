@@ -7,7 +7,9 @@
 
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
+#include "base/json/json_reader.h"
 #include "base/path_service.h"
+#include "base/values.h"
 #include "testing/gtest/include/gtest/gtest.h"
 
 namespace brave_perf_predictor {
@@ -119,4 +121,55 @@ TEST(NamedThirdPartyRegistryTest, HandlesUnrecognisedThirdPartyTest) {
   EXPECT_FALSE(entity.has_value());
 }
 
+TEST(NamedThirdPartyRegistryTest, ExtractsThirdPartyFromDefaultMappings) {
+  NamedThirdPartyRegistry* extractor = new NamedThirdPartyRegistry();
+  extractor->InitializeDefault();
+
+  auto entity = extractor->GetThirdParty("https://google-analytics.com/ga.js");
+  ASSERT_TRUE(entity.has_value());
+  EXPECT_EQ(entity.value(), "Google Analytics");
+
+  entity = extractor->GetThirdParty("https://test.m.facebook.com");
+  ASSERT_TRUE(entity.has_value());
+  EXPECT_EQ(entity.value(), "Facebook");
+
+  entity = extractor->GetThirdParty("http://example.com");
+  EXPECT_FALSE(entity.has_value());
+}
+
+TEST(NamedThirdPartyRegistryTest, DefaultMappingsMatchFullDataset) {
+  NamedThirdPartyRegistry* default_extractor = new NamedThirdPartyRegistry();
+  default_extractor->InitializeDefault();
+  NamedThirdPartyRegistry* extractor = new NamedThirdPartyRegistry();
+  auto dataset = LoadFile();
+  ASSERT_TRUE(extractor->LoadMappings(dataset, true));
+
+  // The prebuilt mappings must be regenerated with export_third_parties.py
+  // whenever the bundled dataset changes
+  base::Optional<base::Value> document = base::JSONReader::Read(dataset);
+  ASSERT_TRUE(document && document->is_list());
+  for (const auto& entity : document->GetList()) {
+    const auto* domains = entity.FindListPath("domains");
+    if (!domains)
+      continue;
+    for (const auto& domain : domains->GetList()) {
+      for (const char* prefix : {"https://", "https://subdomain."}) {
+        const std::string url = prefix + domain.GetString() + "/";
+        EXPECT_EQ(default_extractor->GetThirdParty(url),
+                  extractor->GetThirdParty(url))
+            << url;
+      }
+    }
+  }
+
+  // Hosts under private registries have their own registrable domain, so a
+  // listed domain above the registry doesn't match them
+  for (const char* host :
+       {"x.freetls.fastly.net", "x.a.ssl.fastly.net", "x.apps.fbsbx.com"}) {
+    const std::string url = std::string("https://") + host + "/";
+    EXPECT_FALSE(default_extractor->GetThirdParty(url).has_value()) << url;
+    EXPECT_FALSE(extractor->GetThirdParty(url).has_value()) << url;
+  }
+}
+
 }  // namespace brave_perf_predictor
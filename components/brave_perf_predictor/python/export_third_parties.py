@@ -0,0 +1,168 @@
+"""Exports the third-party entities list to a prebuilt C++ lookup table.
+
+Mirrors what NamedThirdPartyRegistry::LoadMappings builds from the JSON list,
+so that the registry can be initialised without parsing JSON or computing
+registrable domains at runtime:
+
+python export_third_parties.py \\
+    --public_suffix_list <chromium>/net/base/registry_controlled_domains/effective_tld_names.dat
+"""
+
+import argparse
+import ipaddress
+import json
+import re
+
+from config import BASE_URL, EXPORT_OUTPUT_PATH
+
+ENTITIES_PATH = BASE_URL + '../resources/entities-httparchive-nostats.json'
+THIRD_PARTIES_OUTPUT_PATH = BASE_URL + '../browser/named_third_party_entities.h'
+
+HEADER_TEMPLATE = """/* Copyright 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_NAMED_THIRD_PARTY_ENTITIES_H_
+#define BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_NAMED_THIRD_PARTY_ENTITIES_H_
+
+/* This file is automatically generated, do not edit directly */
+
+#include "brave/components/brave_perf_predictor/browser/named_third_party_registry.h"
+
+namespace brave_perf_predictor {{
+
+constexpr const char* kThirdPartyEntityNames[] = {{
+{names}
+}};
+
+// Sorted by domain
+constexpr ThirdPartyDomain kThirdPartyEntityByDomain[] = {{
+{domains}
+}};
+
+// Sorted by domain
+constexpr ThirdPartyDomain kThirdPartyEntityByRootDomain[] = {{
+{root_domains}
+}};
+
+}}  // namespace brave_perf_predictor
+
+#endif  // BRAVE_COMPONENTS_BRAVE_PERF_PREDICTOR_BROWSER_NAMED_THIRD_PARTY_ENTITIES_H_
+"""
+
+
+def load_public_suffix_rules(path):
+    rules = set()
+    with open(path, encoding='utf-8') as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith('//'):
+                continue
+            rules.add(line.split()[0])
+    return rules
+
+
+def get_domain_and_registry(domain, rules):
+    """Equivalent of net::registry_controlled_domains::GetDomainAndRegistry
+    with INCLUDE_PRIVATE_REGISTRIES, returning '' for IP addresses, public
+    suffixes and unknown registries."""
+    try:
+        ipaddress.ip_address(domain)
+        return ''
+    except ValueError:
+        pass
+
+    labels = domain.split('.')
+    registry_length = 0
+    for i in range(len(labels)):
+        suffix = '.'.join(labels[i:])
+        if '!' + suffix in rules:
+            registry_length = len(labels) - i - 1
+            break
+        wildcard = '.'.join(['*'] + labels[i + 1:])
+        if suffix in rules or (i + 1 < len(labels) and wildcard in rules):
+            registry_length = max(registry_length, len(labels) - i)
+
+    if registry_length == 0 or registry_length >= len(labels):
+        return ''
+    return '.'.join(labels[-(registry_length + 1):])
+
+
+def load_relevant_entities():
+    with open(EXPORT_OUTPUT_PATH, encoding='utf-8') as f:
+        parameters = f.read()
+    relevant = re.search(r'relevant_entities\{(.*?)\};', parameters, re.S)
+    return set(re.findall(r'"((?:[^"\\]|\\.)*)"', relevant.group(1)))
+
+
+def build_mappings(entities, relevant_entities, rules):
+    names = []
+    entity_by_domain = {}
+    entity_by_root_domain = {}
+
+    for entity in entities:
+        name = entity.get('name')
+        if name is None or name not in relevant_entities:
+            continue
+        domains = entity.get('domains')
+        if not domains:
+            continue
+        index = len(names)
+        names.append(name)
+
+        for domain in domains:
+            # The first entity listing a domain wins
+            entity_by_domain.setdefault(domain, index)
+
+            root_domain = get_domain_and_registry(domain, rules)
+            if not root_domain:
+                continue
+            root_entity = entity_by_root_domain.get(root_domain)
+            if root_entity is not None and names[root_entity] != name:
+                # If there is a clash at root domain level, neither is correct
+                del entity_by_root_domain[root_domain]
+            else:
+                entity_by_root_domain.setdefault(root_domain, index)
+
+    return names, entity_by_domain, entity_by_root_domain
+
+
+def to_cpp_string(value):
+    return '"' + value.replace('\\', '\\\\').replace('"', '\\"') + '"'
+
+
+def format_domains(entity_by_domain):
+    # Sorted bytewise, as compared by base::StringPiece
+    return '\n'.join(
+        '    {{{}, {}}},'.format(to_cpp_string(domain), entity)
+        for domain, entity in sorted(entity_by_domain.items(),
+                                     key=lambda item: item[0].encode()))
+
+
+def main():
+    parser = argparse.ArgumentParser(
+        description='Export third-party entities to a C++ header')
+    parser.add_argument('--public_suffix_list', required=True,
+                        help='Path to effective_tld_names.dat')
+    parser.add_argument('--entities', default=ENTITIES_PATH)
+    parser.add_argument('--output', default=THIRD_PARTIES_OUTPUT_PATH)
+    args = parser.parse_args()
+
+    with open(args.entities, encoding='utf-8') as f:
+        entities = json.load(f)
+
+    names, entity_by_domain, entity_by_root_domain = build_mappings(
+        entities, load_relevant_entities(),
+        load_public_suffix_rules(args.public_suffix_list))
+
+    with open(args.output, 'w', encoding='utf-8') as f:
+        f.write(HEADER_TEMPLATE.format(
+            names='\n'.join('    {},'.format(to_cpp_string(name))
+                            for name in names),
+            domains=format_domains(entity_by_domain),
+            root_domains=format_domains(entity_by_root_domain)))
+
+
+if __name__ == '__main__':
+    main()
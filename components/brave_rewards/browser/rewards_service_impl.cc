@@ -429,7 +429,7 @@ void RewardsServiceImpl::StartLedger(StartProcessCallback callback) {
   }
 
   ledger_database_.reset(
-      ledger::LedgerDatabase::CreateInstance(publisher_info_db_path_));
+      ledger::LedgerDatabase::CreateInstance(publisher_info_db_path_, true));
 
   BLOG(1, "Starting ledger process");
 
@@ -1388,10 +1388,15 @@ bool RewardsServiceImpl::ResetOnFilesTaskRunner() {
   // Close any open files before deleting them (required on Windows)
   diagnostic_log_.Close();
 
+  // Includes the files SQLite keeps next to the database
   const std::vector<base::FilePath> paths = {
     ledger_state_path_,
     publisher_state_path_,
     publisher_info_db_path_,
+    base::FilePath(publisher_info_db_path_.value() + FILE_PATH_LITERAL("-wal")),
+    base::FilePath(publisher_info_db_path_.value() + FILE_PATH_LITERAL("-shm")),
+    base::FilePath(
+        publisher_info_db_path_.value() + FILE_PATH_LITERAL("-journal")),
     diagnostic_log_path_,
     publisher_list_path_,
   };
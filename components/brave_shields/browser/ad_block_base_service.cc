@@ -6,15 +6,19 @@
 #include "brave/components/brave_shields/browser/ad_block_base_service.h"
 
 #include <algorithm>
+#include <atomic>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/callback_helpers.h"
 #include "base/files/file_path.h"
 #include "base/json/json_reader.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
+#include "base/no_destructor.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/task/post_task.h"
 #include "brave/browser/net/url_context.h"
@@ -34,54 +38,62 @@ using namespace net::registry_controlled_domains;  // NOLINT
 
 namespace {
 
-std::string ResourceTypeToString(blink::mojom::ResourceType resource_type) {
-  std::string filter_option = "";
+std::atomic<uint64_t> g_engines_generation{0};
+
+constexpr size_t kThirdPartyCacheSize = 256;
+
+// Returns a reference to a constant string so that matching doesn't allocate a
+// new filter option string for every request.
+const std::string& ResourceTypeToString(
+    blink::mojom::ResourceType resource_type) {
+  static const base::NoDestructor<std::string> kMainFrame("main_frame");
+  static const base::NoDestructor<std::string> kSubFrame("sub_frame");
+  static const base::NoDestructor<std::string> kStylesheet("stylesheet");
+  static const base::NoDestructor<std::string> kScript("script");
+  static const base::NoDestructor<std::string> kImage("image");
+  static const base::NoDestructor<std::string> kFont("font");
+  static const base::NoDestructor<std::string> kOther("other");
+  static const base::NoDestructor<std::string> kObject("object");
+  static const base::NoDestructor<std::string> kMedia("media");
+  static const base::NoDestructor<std::string> kXhr("xhr");
+  static const base::NoDestructor<std::string> kPing("ping");
+  static const base::NoDestructor<std::string> kEmpty;
+
   switch (resource_type) {
     // top level page
     case blink::mojom::ResourceType::kMainFrame:
-      filter_option = "main_frame";
-      break;
+      return *kMainFrame;
     // frame or iframe
     case blink::mojom::ResourceType::kSubFrame:
-      filter_option = "sub_frame";
-      break;
+      return *kSubFrame;
     // a CSS stylesheet
     case blink::mojom::ResourceType::kStylesheet:
-      filter_option = "stylesheet";
-      break;
+      return *kStylesheet;
     // an external script
     case blink::mojom::ResourceType::kScript:
-      filter_option = "script";
-      break;
+      return *kScript;
     // an image (jpg/gif/png/etc)
     case blink::mojom::ResourceType::kFavicon:
     case blink::mojom::ResourceType::kImage:
-      filter_option = "image";
-      break;
+      return *kImage;
     // a font
     case blink::mojom::ResourceType::kFontResource:
-      filter_option = "font";
-      break;
+      return *kFont;
     // an "other" subresource.
     case blink::mojom::ResourceType::kSubResource:
-      filter_option = "other";
-      break;
+      return *kOther;
     // an object (or embed) tag for a plugin.
     case blink::mojom::ResourceType::kObject:
-      filter_option = "object";
-      break;
+      return *kObject;
     // a media resource.
     case blink::mojom::ResourceType::kMedia:
-      filter_option = "media";
-      break;
+      return *kMedia;
     // a XMLHttpRequest
     case blink::mojom::ResourceType::kXhr:
-      filter_option = "xhr";
-      break;
+      return *kXhr;
     // a ping request for <a ping>/sendBeacon.
     case blink::mojom::ResourceType::kPing:
-      filter_option = "ping";
-      break;
+      return *kPing;
     // the main resource of a dedicated worker.
     case blink::mojom::ResourceType::kWorker:
     // the main resource of a shared worker.
@@ -95,22 +107,38 @@ std::string ResourceTypeToString(blink::mojom::ResourceType resource_type) {
     // a resource that a plugin requested.
     case blink::mojom::ResourceType::kPluginResource:
     default:
-      break;
+      return *kEmpty;
   }
-  return filter_option;
 }
 
 }  // namespace
 
 namespace brave_shields {
 
+AdBlockRequestInfo::AdBlockRequestInfo() = default;
+
+AdBlockRequestInfo::AdBlockRequestInfo(
+    const GURL& url,
+    blink::mojom::ResourceType resource_type,
+    const std::string& tab_host)
+    : url(url), resource_type(resource_type), tab_host(tab_host) {}
+
+AdBlockRequestInfo::AdBlockRequestInfo(const AdBlockRequestInfo& other) =
+    default;
+AdBlockRequestInfo::AdBlockRequestInfo(AdBlockRequestInfo&& other) = default;
+AdBlockRequestInfo& AdBlockRequestInfo::operator=(AdBlockRequestInfo&& other) =
+    default;
+AdBlockRequestInfo::~AdBlockRequestInfo() = default;
+
 AdBlockBaseService::AdBlockBaseService(BraveComponent::Delegate* delegate)
     : BaseBraveShieldsService(delegate),
       ad_block_client_(new adblock::Engine()),
+      third_party_cache_(kThirdPartyCacheSize),
       weak_factory_(this) {}
 
 AdBlockBaseService::~AdBlockBaseService() {
   GetTaskRunner()->DeleteSoon(FROM_HERE, ad_block_client_.release());
+  IncrementEnginesGeneration();
 }
 
 void AdBlockBaseService::ShouldStartRequest(
@@ -121,7 +149,53 @@ void AdBlockBaseService::ShouldStartRequest(
     bool* did_match_exception,
     bool* did_match_important,
     std::string* mock_data_url) {
+  ShouldStartRequestWithEngine(ad_block_client_.get(), url, resource_type,
+                               tab_host, IsThirdParty(url, tab_host),
+                               did_match_rule, did_match_exception,
+                               did_match_important, mock_data_url);
+
+  // LOG(ERROR) << "AdBlockBaseService::ShouldStartRequest(), host: "
+  //  << tab_host
+  //  << ", resource type: " << resource_type
+  //  << ", url.spec(): " << url.spec();
+}
+
+void AdBlockBaseService::ShouldStartRequestWithEngine(
+    adblock::Engine* engine,
+    const GURL& url,
+    blink::mojom::ResourceType resource_type,
+    const std::string& tab_host,
+    bool is_third_party,
+    bool* did_match_rule,
+    bool* did_match_exception,
+    bool* did_match_important,
+    std::string* mock_data_url) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  engine->matches(
+      url.spec(), url.host(), tab_host, is_third_party,
+      ResourceTypeToString(resource_type), did_match_rule,
+      did_match_exception, did_match_important, mock_data_url);
+}
+
+bool AdBlockBaseService::IsThirdParty(const GURL& url,
+                                      const std::string& tab_host) {
   DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  if (tab_host != last_tab_host_) {
+    last_tab_host_ = tab_host;
+    last_tab_site_ = GetDomainAndRegistry(tab_host, INCLUDE_PRIVATE_REGISTRIES);
+    // Hosts without a registrable domain, e.g. IP addresses, only match
+    // themselves.
+    if (last_tab_site_.empty())
+      last_tab_site_ = tab_host;
+  }
+
+  // Whether the request is third party only depends on its host and the
+  // registrable domain of the page, so pages on different subdomains of a site
+  // share entries.
+  auto key = std::make_pair(last_tab_site_, url.host());
+  auto it = third_party_cache_.Get(key);
+  if (it != third_party_cache_.end())
+    return it->second;
 
   // Determine third-party here so the library doesn't need to figure it out.
   // CreateFromNormalizedTuple is needed because SameDomainOrHost needs
@@ -130,15 +204,31 @@ void AdBlockBaseService::ShouldStartRequest(
       url,
       url::Origin::CreateFromNormalizedTuple("https", tab_host.c_str(), 80),
       INCLUDE_PRIVATE_REGISTRIES);
-  ad_block_client_->matches(
-      url.spec(), url.host(), tab_host, is_third_party,
-      ResourceTypeToString(resource_type), did_match_rule,
-      did_match_exception, did_match_important, mock_data_url);
+  third_party_cache_.Put(std::move(key), is_third_party);
+  return is_third_party;
+}
 
-  // LOG(ERROR) << "AdBlockBaseService::ShouldStartRequest(), host: "
-  //  << tab_host
-  //  << ", resource type: " << resource_type
-  //  << ", url.spec(): " << url.spec();
+void AdBlockBaseService::SetThirdParty(
+    base::span<AdBlockRequestInfo> requests) {
+  for (auto& request : requests) {
+    if (!request.is_third_party)
+      request.is_third_party = IsThirdParty(request.url, request.tab_host);
+  }
+}
+
+void AdBlockBaseService::ShouldStartRequests(
+    base::span<AdBlockRequestInfo> requests) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  SetThirdParty(requests);
+  for (auto& request : requests) {
+    if (request.did_match_important)
+      continue;
+    ShouldStartRequestWithEngine(
+        ad_block_client_.get(), request.url, request.resource_type,
+        request.tab_host, *request.is_third_party, &request.did_match_rule,
+        &request.did_match_exception, &request.did_match_important,
+        &request.mock_data_url);
+  }
 }
 
 void AdBlockBaseService::EnableTag(const std::string& tag, bool enabled) {
@@ -160,6 +250,7 @@ void AdBlockBaseService::EnableTag(const std::string& tag, bool enabled) {
       tags_.erase(it);
     }
   }
+  IncrementEnginesGeneration();
 }
 
 void AdBlockBaseService::AddResources(const std::string& resources) {
@@ -172,6 +263,7 @@ void AdBlockBaseService::AddResources(const std::string& resources) {
 
   ad_block_client_->addResources(resources);
   resources_ = resources;
+  IncrementEnginesGeneration();
 }
 
 bool AdBlockBaseService::TagExists(const std::string& tag) {
@@ -194,15 +286,30 @@ base::Optional<base::Value> AdBlockBaseService::HiddenClassIdSelectors(
 }
 
 void AdBlockBaseService::GetDATFileData(const base::FilePath& dat_file_path) {
+  dat_file_path_ = dat_file_path;
+  // Another engine matches on behalf of the released one, RestoreEngine()
+  // loads the new file if it is needed again.
+  if (engine_released_)
+    return;
+  LoadDATFile(base::DoNothing());
+}
+
+void AdBlockBaseService::LoadDATFile(base::OnceClosure callback) {
   base::PostTaskAndReplyWithResult(
       FROM_HERE, {base::ThreadPool(), base::MayBlock()},
       base::BindOnce(&brave_component_updater::LoadDATFileData<adblock::Engine>,
-                     dat_file_path),
+                     dat_file_path_),
       base::BindOnce(&AdBlockBaseService::OnGetDATFileData,
-                     weak_factory_.GetWeakPtr()));
+                     weak_factory_.GetWeakPtr(), std::move(callback)));
 }
 
-void AdBlockBaseService::OnGetDATFileData(GetDATFileDataResult result) {
+void AdBlockBaseService::OnGetDATFileData(base::OnceClosure callback,
+                                          GetDATFileDataResult result) {
+  base::ScopedClosureRunner run_callback(std::move(callback));
+  if (engine_released_) {
+    GetTaskRunner()->DeleteSoon(FROM_HERE, result.first.release());
+    return;
+  }
   if (result.second.empty()) {
     LOG(ERROR) << "Could not obtain ad block data";
     return;
@@ -223,6 +330,7 @@ void AdBlockBaseService::UpdateAdBlockClient(
   ad_block_client_ = std::move(ad_block_client);
   AddKnownTagsToAdBlockInstance();
   AddKnownResourcesToAdBlockInstance();
+  IncrementEnginesGeneration();
 }
 
 void AdBlockBaseService::AddKnownTagsToAdBlockInstance() {
@@ -234,6 +342,38 @@ void AdBlockBaseService::AddKnownResourcesToAdBlockInstance() {
   ad_block_client_->addResources(resources_);
 }
 
+void AdBlockBaseService::AddKnownTagsAndResourcesToEngine(
+    adblock::Engine* engine) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  for (const auto& tag : tags_)
+    engine->addTag(tag);
+  engine->addResources(resources_);
+}
+
+void AdBlockBaseService::ReleaseEngine() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  engine_released_ = true;
+  GetTaskRunner()->PostTask(
+      FROM_HERE, base::BindOnce(&AdBlockBaseService::ReleaseEngineOnTaskRunner,
+                                base::Unretained(this)));
+}
+
+void AdBlockBaseService::ReleaseEngineOnTaskRunner() {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  ad_block_client_.reset(new adblock::Engine());
+  IncrementEnginesGeneration();
+}
+
+void AdBlockBaseService::RestoreEngine(base::OnceClosure callback) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  engine_released_ = false;
+  if (dat_file_path_.empty()) {
+    std::move(callback).Run();
+    return;
+  }
+  LoadDATFile(std::move(callback));
+}
+
 bool AdBlockBaseService::Init() {
   return true;
 }
@@ -243,12 +383,24 @@ void AdBlockBaseService::ResetForTest(const std::string& rules,
   // This is temporary until adblock-rust supports incrementally adding
   // filter rules to an existing instance. At which point the hack below
   // will dissapear.
+  engine_released_ = false;
   ad_block_client_.reset(new adblock::Engine(rules));
   AddKnownTagsToAdBlockInstance();
   if (!resources.empty()) {
     resources_ = resources;
   }
   AddKnownResourcesToAdBlockInstance();
+  IncrementEnginesGeneration();
+}
+
+// static
+uint64_t AdBlockBaseService::GetEnginesGeneration() {
+  return g_engines_generation.load();
+}
+
+// static
+void AdBlockBaseService::IncrementEnginesGeneration() {
+  g_engines_generation++;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -13,8 +13,12 @@
 #include <utility>
 #include <vector>
 
+#include "base/callback_forward.h"
+#include "base/containers/mru_cache.h"
+#include "base/containers/span.h"
 #include "base/files/file_path.h"
 #include "base/memory/weak_ptr.h"
+#include "base/optional.h"
 #include "base/sequence_checker.h"
 #include "base/values.h"
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
@@ -30,6 +34,32 @@ class Engine;
 
 namespace brave_shields {
 
+// A single request to match with ShouldStartRequests(). The did_match_* flags
+// and |mock_data_url| are in/out parameters, the same way as for
+// ShouldStartRequest().
+struct AdBlockRequestInfo {
+  AdBlockRequestInfo();
+  AdBlockRequestInfo(const GURL& url,
+                     blink::mojom::ResourceType resource_type,
+                     const std::string& tab_host);
+  AdBlockRequestInfo(const AdBlockRequestInfo& other);
+  AdBlockRequestInfo(AdBlockRequestInfo&& other);
+  AdBlockRequestInfo& operator=(AdBlockRequestInfo&& other);
+  ~AdBlockRequestInfo();
+
+  GURL url;
+  blink::mojom::ResourceType resource_type =
+      blink::mojom::ResourceType::kSubResource;
+  std::string tab_host;
+  // Computed by the first engine the request is matched against and shared by
+  // the others.
+  base::Optional<bool> is_third_party;
+  bool did_match_rule = false;
+  bool did_match_exception = false;
+  bool did_match_important = false;
+  std::string mock_data_url;
+};
+
 // The base class of the brave shields service in charge of ad-block
 // checking and init.
 class AdBlockBaseService : public BaseBraveShieldsService {
@@ -47,8 +77,12 @@ class AdBlockBaseService : public BaseBraveShieldsService {
                           bool* did_match_exception,
                           bool* did_match_important,
                           std::string* mock_data_url) override;
-  void AddResources(const std::string& resources);
-  void EnableTag(const std::string& tag, bool enabled);
+  // Matches a batch of requests, e.g. a burst of subresources from one frame,
+  // in a single task. Requests which already matched an important rule are
+  // skipped.
+  virtual void ShouldStartRequests(base::span<AdBlockRequestInfo> requests);
+  virtual void AddResources(const std::string& resources);
+  virtual void EnableTag(const std::string& tag, bool enabled);
   bool TagExists(const std::string& tag);
 
   virtual base::Optional<base::Value> UrlCosmeticResources(
@@ -58,6 +92,21 @@ class AdBlockBaseService : public BaseBraveShieldsService {
       const std::vector<std::string>& ids,
       const std::vector<std::string>& exceptions);
 
+  // Replaces the engine with an empty one to free its memory while another
+  // engine matches on its behalf. DAT files which become ready in the
+  // meantime are not loaded until RestoreEngine(). Must be called on the UI
+  // thread.
+  void ReleaseEngine();
+  // Loads the engine freed by ReleaseEngine() again from its DAT file. Must
+  // be called on the UI thread. |callback| runs on the UI thread once the
+  // engine is in place on the task runner, or loading it failed.
+  void RestoreEngine(base::OnceClosure callback);
+
+  // Incremented whenever any ad block engine is replaced or its tags or
+  // resources change, so that results cached from the engines can be
+  // dropped.
+  static uint64_t GetEnginesGeneration();
+
  protected:
   friend class ::AdBlockServiceTest;
   bool Init() override;
@@ -65,18 +114,53 @@ class AdBlockBaseService : public BaseBraveShieldsService {
   void GetDATFileData(const base::FilePath& dat_file_path);
   void AddKnownTagsToAdBlockInstance();
   void AddKnownResourcesToAdBlockInstance();
+  // Applies the known tags and resources to an engine other than
+  // |ad_block_client_|.
+  void AddKnownTagsAndResourcesToEngine(adblock::Engine* engine);
+  // Matches a request against |engine| instead of |ad_block_client_|.
+  void ShouldStartRequestWithEngine(adblock::Engine* engine,
+                                    const GURL& url,
+                                    blink::mojom::ResourceType resource_type,
+                                    const std::string& tab_host,
+                                    bool is_third_party,
+                                    bool* did_match_rule,
+                                    bool* did_match_exception,
+                                    bool* did_match_important,
+                                    std::string* mock_data_url);
+  // Returns whether |url| is third party to a page on |tab_host|. Must be
+  // called on the task runner.
+  bool IsThirdParty(const GURL& url, const std::string& tab_host);
+  // Sets |is_third_party| for each request which doesn't have it yet.
+  void SetThirdParty(base::span<AdBlockRequestInfo> requests);
   void ResetForTest(const std::string& rules, const std::string& resources);
+  static void IncrementEnginesGeneration();
 
   std::unique_ptr<adblock::Engine> ad_block_client_;
 
  private:
   void UpdateAdBlockClient(
       std::unique_ptr<adblock::Engine> ad_block_client);
-  void OnGetDATFileData(GetDATFileDataResult result);
+  // Loads |dat_file_path_| and runs |callback| once the engine was handed to
+  // the task runner or loading it failed.
+  void LoadDATFile(base::OnceClosure callback);
+  void OnGetDATFileData(base::OnceClosure callback,
+                        GetDATFileDataResult result);
+  void ReleaseEngineOnTaskRunner();
   void OnPreferenceChanges(const std::string& pref_name);
 
   std::vector<std::string> tags_;
   std::string resources_;
+  // The last DAT file loaded by GetDATFileData(), used by RestoreEngine().
+  base::FilePath dat_file_path_;
+  // Whether the engine was released by ReleaseEngine(). Only accessed on the
+  // UI thread.
+  bool engine_released_ = false;
+  // (tab eTLD+1, request host) -> is third party. The tab eTLD+1 of the last
+  // tab host is kept as well since requests come in bursts from one page. Only
+  // used on the task runner.
+  base::MRUCache<std::pair<std::string, std::string>, bool> third_party_cache_;
+  std::string last_tab_host_;
+  std::string last_tab_site_;
   base::WeakPtrFactory<AdBlockBaseService> weak_factory_;
   DISALLOW_COPY_AND_ASSIGN(AdBlockBaseService);
 };
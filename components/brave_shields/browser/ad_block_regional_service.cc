@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "base/base_paths.h"
+#include "base/feature_list.h"
 #include "base/files/file_path.h"
 #include "base/logging.h"
 #include "base/macros.h"
@@ -23,6 +24,7 @@
 #include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
+#include "brave/components/brave_shields/common/features.h"
 #include "brave/vendor/adblock_rust_ffi/src/wrapper.h"
 #include "components/prefs/pref_service.h"
 
@@ -83,6 +85,17 @@ void AdBlockRegionalService::OnComponentReady(
                      resources_file_path),
       base::BindOnce(&AdBlockRegionalService::OnResourcesFileDataReady,
                      weak_factory_.GetWeakPtr()));
+
+  if (base::FeatureList::IsEnabled(features::kBraveAdblockCombinedEngine)) {
+    base::FilePath list_text_file_path =
+        install_dir.AppendASCII(kAdBlockListTextFilename);
+    base::PostTaskAndReplyWithResult(
+        GetTaskRunner().get(), FROM_HERE,
+        base::BindOnce(&brave_component_updater::GetDATFileAsString,
+                       list_text_file_path),
+        base::BindOnce(&AdBlockRegionalService::OnListTextFileDataReady,
+                       weak_factory_.GetWeakPtr()));
+  }
 }
 
 void AdBlockRegionalService::OnResourcesFileDataReady(
@@ -91,6 +104,12 @@ void AdBlockRegionalService::OnResourcesFileDataReady(
       resources);
 }
 
+void AdBlockRegionalService::OnListTextFileDataReady(
+    const std::string& list_text) {
+  list_text_ = list_text;
+  g_brave_browser_process->ad_block_service()->ScheduleCombinedEngineRebuild();
+}
+
 // static
 void AdBlockRegionalService::SetComponentIdAndBase64PublicKeyForTest(
     const std::string& component_id,
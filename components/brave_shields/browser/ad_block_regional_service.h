@@ -33,6 +33,8 @@ class AdBlockRegionalService : public AdBlockBaseService {
 
   std::string GetUUID() const { return uuid_; }
   std::string GetTitle() const { return title_; }
+  // Plain text rules of the list, empty unless the component ships them.
+  const std::string& list_text() const { return list_text_; }
 
  protected:
   bool Init() override;
@@ -40,6 +42,7 @@ class AdBlockRegionalService : public AdBlockBaseService {
                         const base::FilePath& install_dir,
                         const std::string& manifest) override;
   void OnResourcesFileDataReady(const std::string& resources);
+  void OnListTextFileDataReady(const std::string& list_text);
 
  private:
   friend class ::AdBlockServiceTest;
@@ -54,6 +57,7 @@ class AdBlockRegionalService : public AdBlockBaseService {
   std::string title_;
   std::string component_id_;
   std::string base64_public_key_;
+  std::string list_text_;
 
   base::WeakPtrFactory<AdBlockRegionalService> weak_factory_{this};
   DISALLOW_COPY_AND_ASSIGN(AdBlockRegionalService);
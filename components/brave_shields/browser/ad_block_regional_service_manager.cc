@@ -9,6 +9,7 @@
 #include <utility>
 #include <vector>
 
+#include "base/barrier_closure.h"
 #include "base/strings/string_util.h"
 #include "base/task/post_task.h"
 #include "base/values.h"
@@ -123,24 +124,16 @@ bool AdBlockRegionalServiceManager::Start() {
   return true;
 }
 
-void AdBlockRegionalServiceManager::ShouldStartRequest(
-    const GURL& url,
-    blink::mojom::ResourceType resource_type,
-    const std::string& tab_host,
-    bool* did_match_rule,
-    bool* did_match_exception,
-    bool* did_match_important,
-    std::string* mock_data_url) {
+void AdBlockRegionalServiceManager::ShouldStartRequests(
+    base::span<AdBlockRequestInfo> requests) {
   base::AutoLock lock(regional_services_lock_);
 
-  for (const auto& regional_service : regional_services_) {
-    regional_service.second->ShouldStartRequest(
-        url, resource_type, tab_host, did_match_rule, did_match_exception,
-        did_match_important, mock_data_url);
-    if (did_match_important && *did_match_important) {
-      return;
-    }
-  }
+  // Every list is matched against the whole batch before moving on to the
+  // next one, which is equivalent to matching each request against every
+  // list in turn, as each list skips the requests already matched as
+  // important.
+  for (const auto& regional_service : regional_services_)
+    regional_service.second->ShouldStartRequests(requests);
 }
 
 void AdBlockRegionalServiceManager::EnableTag(const std::string& tag,
@@ -190,6 +183,37 @@ void AdBlockRegionalServiceManager::EnableFilterList(
       FROM_HERE, {content::BrowserThread::UI},
       base::BindOnce(&AdBlockRegionalServiceManager::UpdateFilterListPrefs,
                      base::Unretained(this), uuid, enabled));
+
+  if (initialized_) {
+    g_brave_browser_process->ad_block_service()
+        ->ScheduleCombinedEngineRebuild();
+  }
+}
+
+void AdBlockRegionalServiceManager::ReleaseEngines() {
+  base::AutoLock lock(regional_services_lock_);
+  for (const auto& regional_service : regional_services_)
+    regional_service.second->ReleaseEngine();
+}
+
+void AdBlockRegionalServiceManager::RestoreEngines(
+    base::OnceClosure callback) {
+  base::AutoLock lock(regional_services_lock_);
+  base::RepeatingClosure barrier =
+      base::BarrierClosure(regional_services_.size(), std::move(callback));
+  for (const auto& regional_service : regional_services_)
+    regional_service.second->RestoreEngine(barrier);
+}
+
+bool AdBlockRegionalServiceManager::GetEnabledListRules(std::string* rules) {
+  base::AutoLock lock(regional_services_lock_);
+  for (const auto& regional_service : regional_services_) {
+    const std::string& list_text = regional_service.second->list_text();
+    if (list_text.empty())
+      return false;
+    rules->append(list_text).append("\n");
+  }
+  return true;
 }
 
 base::Optional<base::Value>
@@ -11,6 +11,8 @@
 #include <string>
 #include <vector>
 
+#include "base/callback_forward.h"
+#include "base/containers/span.h"
 #include "base/macros.h"
 #include "base/memory/scoped_refptr.h"
 #include "base/optional.h"
@@ -32,6 +34,7 @@ using brave_component_updater::BraveComponent;
 namespace brave_shields {
 
 class AdBlockRegionalService;
+struct AdBlockRequestInfo;
 
 // The AdBlock regional service manager, in charge of initializing and
 // managing regional AdBlock clients.
@@ -47,16 +50,23 @@ class AdBlockRegionalServiceManager {
 
   bool IsInitialized() const;
   bool Start();
-  void ShouldStartRequest(const GURL& url,
-                          blink::mojom::ResourceType resource_type,
-                          const std::string& tab_host,
-                          bool* did_match_rule,
-                          bool* did_match_exception,
-                          bool* did_match_important,
-                          std::string* mock_data_url);
+  // Matches all |requests| against every regional list under a single lock
+  // acquisition. Requests which already matched an important rule are
+  // skipped.
+  void ShouldStartRequests(base::span<AdBlockRequestInfo> requests);
   void EnableTag(const std::string& tag, bool enabled);
   void AddResources(const std::string& resources);
   void EnableFilterList(const std::string& uuid, bool enabled);
+  // Frees the engines of all enabled lists while the combined engine matches
+  // on their behalf. Must be called on the UI thread.
+  void ReleaseEngines();
+  // Loads the engines freed by ReleaseEngines() again. Must be called on the
+  // UI thread. |callback| runs on the UI thread once all of them are in place
+  // on the task runner.
+  void RestoreEngines(base::OnceClosure callback);
+  // Concatenates the plain text rules of all enabled lists into |rules|.
+  // Returns false if any enabled list didn't ship its rules as text.
+  bool GetEnabledListRules(std::string* rules);
 
   base::Optional<base::Value> UrlCosmeticResources(
           const std::string& url);
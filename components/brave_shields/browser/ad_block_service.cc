@@ -6,16 +6,22 @@
 #include "brave/components/brave_shields/browser/ad_block_service.h"
 
 #include <algorithm>
+#include <memory>
 #include <utility>
 
 #include "base/base_paths.h"
+#include "base/barrier_closure.h"
 #include "base/bind.h"
+#include "base/bind_helpers.h"
+#include "base/feature_list.h"
 #include "base/files/file_path.h"
+#include "base/json/json_reader.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/utf_string_conversions.h"
+#include "base/task/post_task.h"
 #include "base/threading/thread_restrictions.h"
 #include "brave/browser/brave_browser_process_impl.h"
 #include "brave/common/pref_names.h"
@@ -23,11 +29,15 @@
 #include "brave/components/brave_shields/browser/ad_block_regional_service_manager.h"
 #include "brave/components/brave_shields/browser/ad_block_service_helper.h"
 #include "brave/components/brave_shields/common/brave_shield_constants.h"
+#include "brave/components/brave_shields/common/features.h"
 #include "brave/vendor/adblock_rust_ffi/src/wrapper.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/pref_service.h"
+#include "content/public/browser/browser_task_traits.h"
 #include "net/base/registry_controlled_domains/registry_controlled_domain.h"
 
+using content::BrowserThread;
+
 #define DAT_FILE "rs-ABPFilterParserData.dat"
 #define REGIONAL_CATALOG "regional_catalog.json"
 
@@ -35,6 +45,24 @@ namespace brave_shields {
 
 namespace {
 
+// Coalesces bursts of list changes, e.g. while the regional lists are
+// starting up, into a single combined engine build.
+constexpr base::TimeDelta kCombinedEngineRebuildDelay =
+    base::TimeDelta::FromSeconds(1);
+
+constexpr size_t kCosmeticResourcesCacheSize = 32;
+constexpr size_t kGenericHideCacheSize = 1024;
+
+// Hostnames can't contain new lines, so the key is unambiguous.
+std::string CosmeticResourcesKey(const std::string& host, bool generichide) {
+  return host + (generichide ? "\n1" : "\n0");
+}
+
+std::unique_ptr<adblock::Engine> BuildCombinedEngine(
+    const std::string& rules) {
+  return std::make_unique<adblock::Engine>(rules);
+}
+
 std::string GetTagFromPrefName(const std::string& pref_name) {
   if (pref_name == kFBEmbedControlType) {
     return brave_shields::kFacebookEmbeds;
@@ -81,27 +109,143 @@ void AdBlockService::ShouldStartRequest(
     bool* did_match_exception,
     bool* did_match_important,
     std::string* mock_data_url) {
-  AdBlockBaseService::ShouldStartRequest(
-      url, resource_type, tab_host, did_match_rule, did_match_exception,
-      did_match_important, mock_data_url);
-  if (did_match_important && *did_match_important) {
+  AdBlockRequestInfo request(url, resource_type, tab_host);
+  if (did_match_rule)
+    request.did_match_rule = *did_match_rule;
+  if (did_match_exception)
+    request.did_match_exception = *did_match_exception;
+  if (did_match_important)
+    request.did_match_important = *did_match_important;
+  if (mock_data_url)
+    request.mock_data_url = *mock_data_url;
+
+  ShouldStartRequests(base::make_span(&request, 1));
+
+  if (did_match_rule)
+    *did_match_rule = request.did_match_rule;
+  if (did_match_exception)
+    *did_match_exception = request.did_match_exception;
+  if (did_match_important)
+    *did_match_important = request.did_match_important;
+  if (mock_data_url)
+    *mock_data_url = std::move(request.mock_data_url);
+}
+
+void AdBlockService::ShouldStartRequests(
+    base::span<AdBlockRequestInfo> requests) {
+  // The registry lookup is done once per request rather than by every
+  // engine the request is matched against.
+  SetThirdParty(requests);
+
+  // Each stage skips requests which already matched an important rule.
+  if (combined_engine_) {
+    for (auto& request : requests) {
+      if (request.did_match_important)
+        continue;
+      ShouldStartRequestWithEngine(
+          combined_engine_.get(), request.url, request.resource_type,
+          request.tab_host, *request.is_third_party, &request.did_match_rule,
+          &request.did_match_exception, &request.did_match_important,
+          &request.mock_data_url);
+    }
+  } else {
+    AdBlockBaseService::ShouldStartRequests(requests);
+    regional_service_manager()->ShouldStartRequests(requests);
+  }
+  custom_filters_service()->ShouldStartRequests(requests);
+}
+
+void AdBlockService::AddResources(const std::string& resources) {
+  if (BrowserThread::CurrentlyOn(BrowserThread::UI)) {
+    GetTaskRunner()->PostTask(
+        FROM_HERE, base::BindOnce(&AdBlockService::AddResources,
+                                  base::Unretained(this), resources));
     return;
   }
 
-  regional_service_manager()->ShouldStartRequest(
-      url, resource_type, tab_host, did_match_rule, did_match_exception,
-      did_match_important, mock_data_url);
-  if (did_match_important && *did_match_important) {
+  AdBlockBaseService::AddResources(resources);
+  if (combined_engine_)
+    combined_engine_->addResources(resources);
+}
+
+void AdBlockService::EnableTag(const std::string& tag, bool enabled) {
+  if (BrowserThread::CurrentlyOn(BrowserThread::UI)) {
+    GetTaskRunner()->PostTask(
+        FROM_HERE, base::BindOnce(&AdBlockService::EnableTag,
+                                  base::Unretained(this), tag, enabled));
     return;
   }
 
-  custom_filters_service()->ShouldStartRequest(
-      url, resource_type, tab_host, did_match_rule, did_match_exception,
-      did_match_important, mock_data_url);
+  AdBlockBaseService::EnableTag(tag, enabled);
+  if (!combined_engine_)
+    return;
+  if (enabled)
+    combined_engine_->addTag(tag);
+  else
+    combined_engine_->removeTag(tag);
 }
 
 base::Optional<base::Value> AdBlockService::UrlCosmeticResources(
     const std::string& url) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  MaybeClearCosmeticCaches();
+
+  // Cosmetic resources only depend on the hostname and on whether a
+  // $generichide exception applies. The exception can match on the path and
+  // the engines have no cheaper way to check for it than building the
+  // resources, so the bit is remembered per URL and the resources per
+  // hostname and bit. The fragment is never seen by the engines.
+  const GURL gurl(url);
+  GURL::Replacements clear_ref;
+  clear_ref.ClearRef();
+  const std::string url_key = gurl.ReplaceComponents(clear_ref).spec();
+  auto generichide_it = generichide_cache_.Get(url_key);
+  if (generichide_it != generichide_cache_.end()) {
+    auto it = cosmetic_resources_cache_.Get(
+        CosmeticResourcesKey(gurl.host(), generichide_it->second));
+    if (it != cosmetic_resources_cache_.end())
+      return it->second.Clone();
+  }
+
+  base::Optional<base::Value> resources = MergedUrlCosmeticResources(url);
+  if (resources && resources->is_dict()) {
+    const bool generichide =
+        resources->FindBoolKey("generichide").value_or(false);
+    generichide_cache_.Put(url_key, generichide);
+    cosmetic_resources_cache_.Put(
+        CosmeticResourcesKey(gurl.host(), generichide), resources->Clone());
+  }
+  return resources;
+}
+
+base::Optional<base::Value> AdBlockService::HiddenClassIdSelectors(
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
+    const std::vector<std::string>& exceptions) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  return MergedHiddenClassIdSelectors(classes, ids, exceptions);
+}
+
+void AdBlockService::MaybeClearCosmeticCaches() {
+  const uint64_t generation = GetEnginesGeneration();
+  if (generation == cosmetic_caches_generation_)
+    return;
+  cosmetic_resources_cache_.Clear();
+  generichide_cache_.Clear();
+  cosmetic_caches_generation_ = generation;
+}
+
+base::Optional<base::Value> AdBlockService::MergedUrlCosmeticResources(
+    const std::string& url) {
+  if (combined_engine_) {
+    base::Optional<base::Value> resources =
+        base::JSONReader::Read(combined_engine_->urlCosmeticResources(url));
+    if (!resources || !resources->is_dict())
+      return resources;
+    MergeCustomUrlCosmeticResources(url, &*resources);
+    return resources;
+  }
+
   base::Optional<base::Value> resources =
       AdBlockBaseService::UrlCosmeticResources(url);
 
@@ -117,27 +261,36 @@ base::Optional<base::Value> AdBlockService::UrlCosmeticResources(
                        /*force_hide=*/false);
   }
 
+  MergeCustomUrlCosmeticResources(url, &*resources);
+  return resources;
+}
+
+void AdBlockService::MergeCustomUrlCosmeticResources(const std::string& url,
+                                                     base::Value* resources) {
   base::Optional<base::Value> custom_resources =
       custom_filters_service()->UrlCosmeticResources(url);
 
   if (custom_resources && custom_resources->is_dict()) {
-    MergeResourcesInto(std::move(*custom_resources), &*resources,
+    MergeResourcesInto(std::move(*custom_resources), resources,
                        /*force_hide=*/true);
   }
-
-  return resources;
 }
 
-base::Optional<base::Value> AdBlockService::HiddenClassIdSelectors(
+base::Optional<base::Value> AdBlockService::MergedHiddenClassIdSelectors(
     const std::vector<std::string>& classes,
     const std::vector<std::string>& ids,
     const std::vector<std::string>& exceptions) {
-  base::Optional<base::Value> hide_selectors =
-      AdBlockBaseService::HiddenClassIdSelectors(classes, ids, exceptions);
-
-  base::Optional<base::Value> regional_selectors =
-      regional_service_manager()->HiddenClassIdSelectors(classes, ids,
-                                                         exceptions);
+  base::Optional<base::Value> hide_selectors;
+  base::Optional<base::Value> regional_selectors;
+  if (combined_engine_) {
+    hide_selectors = base::JSONReader::Read(
+        combined_engine_->hiddenClassIdSelectors(classes, ids, exceptions));
+  } else {
+    hide_selectors =
+        AdBlockBaseService::HiddenClassIdSelectors(classes, ids, exceptions);
+    regional_selectors = regional_service_manager()->HiddenClassIdSelectors(
+        classes, ids, exceptions);
+  }
 
   base::Optional<base::Value> custom_selectors =
       custom_filters_service()->HiddenClassIdSelectors(classes, ids,
@@ -181,9 +334,14 @@ AdBlockService::custom_filters_service() {
 
 AdBlockService::AdBlockService(
     brave_component_updater::BraveComponent::Delegate* delegate)
-    : AdBlockBaseService(delegate), component_delegate_(delegate) {}
+    : AdBlockBaseService(delegate),
+      cosmetic_resources_cache_(kCosmeticResourcesCacheSize),
+      generichide_cache_(kGenericHideCacheSize),
+      component_delegate_(delegate) {}
 
-AdBlockService::~AdBlockService() {}
+AdBlockService::~AdBlockService() {
+  GetTaskRunner()->DeleteSoon(FROM_HERE, combined_engine_.release());
+}
 
 bool AdBlockService::Init() {
   // Initializes adblock-rust's domain resolution implementation
@@ -223,6 +381,159 @@ void AdBlockService::OnComponentReady(const std::string& component_id,
                      regional_catalog_file_path),
       base::BindOnce(&AdBlockService::OnRegionalCatalogFileDataReady,
                      weak_factory_.GetWeakPtr()));
+
+  if (base::FeatureList::IsEnabled(features::kBraveAdblockCombinedEngine)) {
+    base::FilePath list_text_file_path =
+        install_dir.AppendASCII(kAdBlockListTextFilename);
+    base::PostTaskAndReplyWithResult(
+        GetTaskRunner().get(), FROM_HERE,
+        base::BindOnce(&brave_component_updater::GetDATFileAsString,
+                       list_text_file_path),
+        base::BindOnce(&AdBlockService::OnListTextFileDataReady,
+                       weak_factory_.GetWeakPtr()));
+  }
+}
+
+void AdBlockService::OnListTextFileDataReady(const std::string& list_text) {
+  list_text_ = list_text;
+  ScheduleCombinedEngineRebuild();
+}
+
+void AdBlockService::ScheduleCombinedEngineRebuild() {
+  if (!base::FeatureList::IsEnabled(features::kBraveAdblockCombinedEngine))
+    return;
+
+  if (!BrowserThread::CurrentlyOn(BrowserThread::UI)) {
+    base::PostTask(
+        FROM_HERE, {BrowserThread::UI},
+        base::BindOnce(&AdBlockService::ScheduleCombinedEngineRebuild,
+                       base::Unretained(this)));
+    return;
+  }
+
+  combined_engine_generation_++;
+  // Fall back to the per list engines until the new engine is ready, the
+  // current one no longer reflects the enabled lists. Once they have been
+  // released the current engine keeps matching until it is replaced, or until
+  // they are loaded again, instead.
+  if (!per_list_engines_released_ && !restoring_per_list_engines_) {
+    GetTaskRunner()->PostTask(
+        FROM_HERE, base::BindOnce(&AdBlockService::SetCombinedEngine,
+                                  base::Unretained(this),
+                                  std::unique_ptr<adblock::Engine>()));
+  }
+  combined_engine_rebuild_timer_.Start(
+      FROM_HERE, kCombinedEngineRebuildDelay,
+      base::BindOnce(&AdBlockService::RebuildCombinedEngine,
+                     base::Unretained(this)));
+}
+
+void AdBlockService::RebuildCombinedEngine() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  std::string regional_rules;
+  if (list_text_.empty() ||
+      !regional_service_manager()->GetEnabledListRules(&regional_rules)) {
+    DropCombinedEngine();
+    return;
+  }
+
+  // Custom filters keep their own engine, which is matched after this one,
+  // as custom cosmetic filters take precedence over list exceptions.
+  std::string rules = list_text_;
+  rules.append("\n").append(regional_rules);
+
+  base::PostTaskAndReplyWithResult(
+      FROM_HERE, {base::ThreadPool(), base::MayBlock()},
+      base::BindOnce(&BuildCombinedEngine, std::move(rules)),
+      base::BindOnce(&AdBlockService::OnCombinedEngineBuilt,
+                     weak_factory_.GetWeakPtr(),
+                     combined_engine_generation_));
+}
+
+void AdBlockService::OnCombinedEngineBuilt(
+    uint64_t generation,
+    std::unique_ptr<adblock::Engine> engine) {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  if (generation != combined_engine_generation_) {
+    GetTaskRunner()->DeleteSoon(FROM_HERE, engine.release());
+    return;
+  }
+  per_list_engines_released_ = true;
+  GetTaskRunner()->PostTask(
+      FROM_HERE,
+      base::BindOnce(&AdBlockService::SetCombinedEngine,
+                     base::Unretained(this), std::move(engine)));
+  // The combined engine holds the rules of the default and regional lists,
+  // so their engines only waste memory now. Releasing them is posted after
+  // the combined engine is set, so requests are always matched.
+  ReleaseEngine();
+  regional_service_manager()->ReleaseEngines();
+}
+
+void AdBlockService::SetCombinedEngine(
+    std::unique_ptr<adblock::Engine> engine) {
+  DCHECK(GetTaskRunner()->RunsTasksInCurrentSequence());
+  combined_engine_ = std::move(engine);
+  IncrementEnginesGeneration();
+  if (combined_engine_)
+    AddKnownTagsAndResourcesToEngine(combined_engine_.get());
+}
+
+void AdBlockService::DropCombinedEngine() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  // OnPerListEnginesRestored() drops the combined engine once the per list
+  // engines are loaded again.
+  if (restoring_per_list_engines_)
+    return;
+
+  if (!per_list_engines_released_) {
+    GetTaskRunner()->PostTask(
+        FROM_HERE, base::BindOnce(&AdBlockService::SetCombinedEngine,
+                                  base::Unretained(this),
+                                  std::unique_ptr<adblock::Engine>()));
+    return;
+  }
+
+  // The combined engine keeps matching until the default and regional
+  // engines are loaded again, so that blocking doesn't stop in between. This
+  // only happens when a list without plain text rules is enabled or updated
+  // after the combined engine was built.
+  per_list_engines_released_ = false;
+  restoring_per_list_engines_ = true;
+  base::RepeatingClosure barrier = base::BarrierClosure(
+      2, base::BindOnce(&AdBlockService::OnPerListEnginesRestored,
+                        weak_factory_.GetWeakPtr()));
+  RestoreEngine(barrier);
+  regional_service_manager()->RestoreEngines(barrier);
+}
+
+void AdBlockService::OnPerListEnginesRestored() {
+  DCHECK_CURRENTLY_ON(BrowserThread::UI);
+  restoring_per_list_engines_ = false;
+  // A combined engine built in the meantime already replaced the current one
+  // and released the per list engines again.
+  if (per_list_engines_released_)
+    return;
+
+  // Posted after the per list engines, so they are in place by the time the
+  // combined engine is dropped.
+  GetTaskRunner()->PostTask(
+      FROM_HERE, base::BindOnce(&AdBlockService::SetCombinedEngine,
+                                base::Unretained(this),
+                                std::unique_ptr<adblock::Engine>()));
+}
+
+void AdBlockService::ResetForTest(const std::string& rules,
+                                  const std::string& resources) {
+  combined_engine_generation_++;
+  combined_engine_rebuild_timer_.Stop();
+  combined_engine_.reset();
+  restoring_per_list_engines_ = false;
+  if (per_list_engines_released_) {
+    per_list_engines_released_ = false;
+    regional_service_manager()->RestoreEngines(base::DoNothing());
+  }
+  AdBlockBaseService::ResetForTest(rules, resources);
 }
 
 void AdBlockService::OnResourcesFileDataReady(const std::string& resources) {
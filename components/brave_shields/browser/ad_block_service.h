@@ -12,7 +12,9 @@
 #include <string>
 #include <vector>
 
+#include "base/containers/mru_cache.h"
 #include "base/optional.h"
+#include "base/timer/timer.h"
 #include "base/values.h"
 #include "brave/components/brave_shields/browser/ad_block_base_service.h"
 #include "components/keyed_service/core/keyed_service.h"
@@ -31,6 +33,9 @@ class AdBlockRegionalServiceManager;
 class AdBlockCustomFiltersService;
 
 const char kAdBlockResourcesFilename[] = "resources.json";
+// Optional plain text filter list shipped next to the DAT file, used to
+// build the combined engine.
+const char kAdBlockListTextFilename[] = "list.txt";
 const char kAdBlockComponentName[] = "Brave Ad Block Updater";
 const char kAdBlockComponentId[] = "cffkpbalmllkdoenhmdmpbkajipdjfam";
 const char kAdBlockComponentBase64PublicKey[] =
@@ -55,6 +60,9 @@ class AdBlockService : public AdBlockBaseService {
                           bool* did_match_exception,
                           bool* did_match_important,
                           std::string* mock_data_url) override;
+  void ShouldStartRequests(base::span<AdBlockRequestInfo> requests) override;
+  void AddResources(const std::string& resources) override;
+  void EnableTag(const std::string& tag, bool enabled) override;
   base::Optional<base::Value> UrlCosmeticResources(
       const std::string& url) override;
   base::Optional<base::Value> HiddenClassIdSelectors(
@@ -65,6 +73,11 @@ class AdBlockService : public AdBlockBaseService {
   AdBlockRegionalServiceManager* regional_service_manager();
   AdBlockCustomFiltersService* custom_filters_service();
 
+  // Discards the combined engine and, after a short delay, rebuilds it off
+  // the UI thread from the default and enabled regional lists. Does nothing
+  // unless the combined engine feature is enabled.
+  void ScheduleCombinedEngineRebuild();
+
  protected:
   bool Init() override;
   void OnComponentReady(const std::string& component_id,
@@ -72,6 +85,7 @@ class AdBlockService : public AdBlockBaseService {
                         const std::string& manifest) override;
   void OnResourcesFileDataReady(const std::string& resources);
   void OnRegionalCatalogFileDataReady(const std::string& catalog_json);
+  void OnListTextFileDataReady(const std::string& list_text);
 
  private:
   friend class ::AdBlockServiceTest;
@@ -82,6 +96,59 @@ class AdBlockService : public AdBlockBaseService {
       const std::string& component_id,
       const std::string& component_base64_public_key);
 
+  base::Optional<base::Value> MergedUrlCosmeticResources(
+      const std::string& url);
+  // Merges the cosmetic resources of the custom filters into |resources|.
+  void MergeCustomUrlCosmeticResources(const std::string& url,
+                                       base::Value* resources);
+  base::Optional<base::Value> MergedHiddenClassIdSelectors(
+      const std::vector<std::string>& classes,
+      const std::vector<std::string>& ids,
+      const std::vector<std::string>& exceptions);
+  // Drops the cached cosmetic results if any engine changed since they were
+  // computed.
+  void MaybeClearCosmeticCaches();
+
+  // Hides AdBlockBaseService::ResetForTest() to also drop the combined
+  // engine, which would otherwise keep matching the previous rules.
+  void ResetForTest(const std::string& rules, const std::string& resources);
+
+  void RebuildCombinedEngine();
+  // Stops using the combined engine and loads the per list engines again if
+  // they were released.
+  void DropCombinedEngine();
+  void OnPerListEnginesRestored();
+  void OnCombinedEngineBuilt(uint64_t generation,
+                             std::unique_ptr<adblock::Engine> engine);
+  void SetCombinedEngine(std::unique_ptr<adblock::Engine> engine);
+
+  // Merged default + regional + custom cosmetic resources keyed by hostname
+  // and generichide bit, and the generichide bit of recently seen page URLs,
+  // so that repeated loads of a site don't query and parse the engines
+  // again. Only used on the task runner.
+  base::MRUCache<std::string, base::Value> cosmetic_resources_cache_;
+  base::MRUCache<std::string, bool> generichide_cache_;
+  uint64_t cosmetic_caches_generation_ = 0;
+
+  // Single engine replacing the default -> regional chain for network
+  // requests and the default and regional engines for cosmetic filtering.
+  // The custom filters engine is still matched after it. Only accessed on
+  // the task runner; null until it is first built or when some enabled list
+  // has no list text.
+  std::unique_ptr<adblock::Engine> combined_engine_;
+  // Whether the default and regional engines were released in favour of
+  // |combined_engine_|. In that case the combined engine keeps matching
+  // while it is rebuilt. Only accessed on the UI thread.
+  bool per_list_engines_released_ = false;
+  // Whether DropCombinedEngine() is waiting for the per list engines to load
+  // before dropping |combined_engine_|. Only accessed on the UI thread.
+  bool restoring_per_list_engines_ = false;
+  // Default list rules, kept on the UI thread to rebuild |combined_engine_|.
+  std::string list_text_;
+  base::OneShotTimer combined_engine_rebuild_timer_;
+  // Bumped on every rebuild request so stale builds are dropped.
+  uint64_t combined_engine_generation_ = 0;
+
   std::unique_ptr<brave_shields::AdBlockRegionalServiceManager>
       regional_service_manager_;
   std::unique_ptr<brave_shields::AdBlockCustomFiltersService>
@@ -28,3 +28,24 @@ TEST(HTTPSEverywhereRecentlyUsedCacheTest, Operations) {
   cache.remove("kD");
   ASSERT_FALSE(cache.get("kD", &v));
 }
+
+TEST(HTTPSEverywhereRecentlyUsedCacheTest, Sharded) {
+  using Cache = HTTPSERecentlyUsedCache<bool>;
+  Cache cache(64, 8);
+
+  for (int i = 0; i < 8; ++i)
+    cache.add("host" + std::to_string(i), i % 2 == 0);
+
+  bool v = false;
+  for (int i = 0; i < 8; ++i) {
+    ASSERT_TRUE(cache.get("host" + std::to_string(i), &v));
+    ASSERT_EQ(i % 2 == 0, v);
+  }
+  ASSERT_FALSE(cache.get("unknown", &v));
+  ASSERT_EQ(8u, cache.hits());
+  ASSERT_EQ(1u, cache.misses());
+
+  cache.clear();
+  ASSERT_FALSE(cache.get("host0", &v));
+  ASSERT_EQ(2u, cache.misses());
+}
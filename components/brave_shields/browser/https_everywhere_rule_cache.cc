@@ -0,0 +1,216 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_rule_cache.h"
+
+#include <utility>
+
+#include "base/json/json_reader.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "base/values.h"
+#include "third_party/re2/src/re2/re2.h"
+
+namespace brave_shields {
+
+namespace {
+
+// Compiled RE2 programs are not directly measurable, so approximate their
+// footprint from the number of instructions.
+constexpr size_t kEstimatedBytesPerRE2Instruction = 16;
+
+std::unique_ptr<re2::RE2> CompilePattern(const std::string& pattern) {
+  auto re = std::make_unique<re2::RE2>(pattern, re2::RE2::Quiet);
+  if (!re->ok())
+    return nullptr;
+  return re;
+}
+
+size_t EstimateRE2MemoryUsage(const re2::RE2& re) {
+  return sizeof(re2::RE2) + re.pattern().size() +
+         re.ProgramSize() * kEstimatedBytesPerRE2Instruction;
+}
+
+}  // namespace
+
+HTTPSECompiledRuleSet::Rule::Rule() = default;
+HTTPSECompiledRuleSet::Rule::Rule(Rule&& other) = default;
+HTTPSECompiledRuleSet::Rule::~Rule() = default;
+
+HTTPSECompiledRuleSet::RuleSet::RuleSet() = default;
+HTTPSECompiledRuleSet::RuleSet::RuleSet(RuleSet&& other) = default;
+HTTPSECompiledRuleSet::RuleSet::~RuleSet() = default;
+
+HTTPSECompiledRuleSet::HTTPSECompiledRuleSet() = default;
+HTTPSECompiledRuleSet::~HTTPSECompiledRuleSet() = default;
+
+// static
+std::unique_ptr<HTTPSECompiledRuleSet> HTTPSECompiledRuleSet::Parse(
+    const std::string& json) {
+  base::Optional<base::Value> json_object = base::JSONReader::Read(json);
+  if (!json_object || !json_object->is_list())
+    return nullptr;
+
+  auto compiled = base::WrapUnique(new HTTPSECompiledRuleSet());
+  compiled->memory_usage_ = sizeof(HTTPSECompiledRuleSet);
+
+  for (const auto& ruleset_value : json_object->GetList()) {
+    if (!ruleset_value.is_dict())
+      continue;
+
+    RuleSet ruleset;
+    const base::Value* exclusions = ruleset_value.FindListKey("e");
+    if (exclusions) {
+      for (const auto& exclusion : exclusions->GetList()) {
+        if (!exclusion.is_dict())
+          continue;
+        const std::string* pattern = exclusion.FindStringKey("p");
+        if (!pattern)
+          continue;
+        // Patterns which fail to compile can never match, drop them.
+        auto re = CompilePattern(CorrecttoRuleToRE2Engine(*pattern));
+        if (!re)
+          continue;
+        compiled->memory_usage_ += EstimateRE2MemoryUsage(*re);
+        ruleset.exclusions.push_back(std::move(re));
+      }
+    }
+
+    const base::Value* rules = ruleset_value.FindListKey("r");
+    ruleset.has_rules = rules != nullptr;
+    if (rules) {
+      for (const auto& rule_value : rules->GetList()) {
+        if (!rule_value.is_dict())
+          continue;
+        Rule rule;
+        if (rule_value.FindKey("d")) {
+          rule.upgrade_scheme = true;
+          ruleset.rules.push_back(std::move(rule));
+          // Nothing after an upgrade rule is ever reached.
+          break;
+        }
+        const std::string* from = rule_value.FindStringKey("f");
+        const std::string* to = rule_value.FindStringKey("t");
+        if (!from || !to)
+          continue;
+        rule.from = CompilePattern(*from);
+        if (!rule.from)
+          continue;
+        rule.to = CorrecttoRuleToRE2Engine(*to);
+        compiled->memory_usage_ +=
+            EstimateRE2MemoryUsage(*rule.from) + rule.to.size();
+        ruleset.rules.push_back(std::move(rule));
+      }
+    }
+
+    compiled->memory_usage_ += sizeof(RuleSet) +
+                               ruleset.exclusions.size() * sizeof(void*) +
+                               ruleset.rules.size() * sizeof(Rule);
+    const bool terminal = !ruleset.has_rules;
+    compiled->rulesets_.push_back(std::move(ruleset));
+    // Evaluation never goes past a ruleset without rules.
+    if (terminal)
+      break;
+  }
+
+  return compiled;
+}
+
+// static
+std::string HTTPSECompiledRuleSet::CorrecttoRuleToRE2Engine(
+    const std::string& to) {
+  std::string correctedto(to);
+  size_t pos = correctedto.find("$");
+  while (std::string::npos != pos) {
+    correctedto[pos] = '\\';
+    pos = correctedto.find("$", pos + 1);
+  }
+
+  return correctedto;
+}
+
+std::string HTTPSECompiledRuleSet::Apply(
+    const std::string& original_url) const {
+  for (const auto& ruleset : rulesets_) {
+    for (const auto& exclusion : ruleset.exclusions) {
+      if (re2::RE2::FullMatch(original_url, *exclusion))
+        return "";
+    }
+
+    if (!ruleset.has_rules)
+      return "";
+
+    for (const auto& rule : ruleset.rules) {
+      if (rule.upgrade_scheme) {
+        std::string new_url(original_url);
+        return new_url.insert(4, "s");
+      }
+
+      std::string new_url(original_url);
+      if (re2::RE2::Replace(&new_url, *rule.from, rule.to) &&
+          new_url != original_url) {
+        return new_url;
+      }
+    }
+  }
+  return "";
+}
+
+bool HTTPSECompiledRuleSet::UpgradesAllURLs() const {
+  if (rulesets_.empty())
+    return false;
+  const RuleSet& first = rulesets_.front();
+  return first.exclusions.empty() && !first.rules.empty() &&
+         first.rules.front().upgrade_scheme;
+}
+
+size_t HTTPSECompiledRuleSet::EstimateMemoryUsage() const {
+  return memory_usage_;
+}
+
+HTTPSERuleCache::HTTPSERuleCache(size_t max_memory_bytes)
+    : cache_(decltype(cache_)::NO_AUTO_EVICT),
+      max_memory_bytes_(max_memory_bytes) {}
+
+HTTPSERuleCache::~HTTPSERuleCache() = default;
+
+const HTTPSECompiledRuleSet* HTTPSERuleCache::Get(const std::string& key) {
+  auto it = cache_.Get(key);
+  if (it == cache_.end())
+    return nullptr;
+  return it->second.get();
+}
+
+void HTTPSERuleCache::Put(const std::string& key,
+                          std::unique_ptr<HTTPSECompiledRuleSet> ruleset) {
+  DCHECK(ruleset);
+  auto existing = cache_.Peek(key);
+  if (existing != cache_.end()) {
+    memory_usage_ -= existing->second->EstimateMemoryUsage() + key.size();
+    cache_.Erase(existing);
+  }
+
+  memory_usage_ += ruleset->EstimateMemoryUsage() + key.size();
+  cache_.Put(key, std::move(ruleset));
+  EvictIfNeeded();
+}
+
+void HTTPSERuleCache::Clear() {
+  cache_.Clear();
+  memory_usage_ = 0;
+}
+
+void HTTPSERuleCache::EvictIfNeeded() {
+  // Never evict the most recently used entry so that the ruleset handed to
+  // Put() stays alive until the next cache mutation.
+  while (memory_usage_ > max_memory_bytes_ && cache_.size() > 1) {
+    auto oldest = cache_.rbegin();
+    memory_usage_ -=
+        oldest->second->EstimateMemoryUsage() + oldest->first.size();
+    cache_.Erase(oldest);
+  }
+}
+
+}  // namespace brave_shields
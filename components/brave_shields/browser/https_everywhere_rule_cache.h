@@ -0,0 +1,110 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_CACHE_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_CACHE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/containers/mru_cache.h"
+#include "base/macros.h"
+
+namespace re2 {
+class RE2;
+}  // namespace re2
+
+namespace brave_shields {
+
+// Parsed form of a single HTTPSE database value, i.e. the JSON list of
+// rulesets stored under one reversed domain key. All exclusion and `from`
+// patterns are compiled once so that applying the ruleset to a URL does not
+// touch the JSON parser or the RE2 compiler.
+class HTTPSECompiledRuleSet {
+ public:
+  ~HTTPSECompiledRuleSet();
+
+  // Returns nullptr if |json| is not a list of rulesets.
+  static std::unique_ptr<HTTPSECompiledRuleSet> Parse(const std::string& json);
+
+  // Replaces `$N` back-references with the `\N` form RE2 expects.
+  static std::string CorrecttoRuleToRE2Engine(const std::string& to);
+
+  // Returns the rewritten URL or an empty string if no rule applies.
+  std::string Apply(const std::string& original_url) const;
+
+  // Returns true if Apply() upgrades every URL to https regardless of its
+  // path, so the result can be cached for the whole host.
+  bool UpgradesAllURLs() const;
+
+  // Rough number of bytes held by this ruleset, used to bound the cache.
+  size_t EstimateMemoryUsage() const;
+
+ private:
+  struct Rule {
+    Rule();
+    Rule(Rule&& other);
+    ~Rule();
+
+    // "d" rules simply upgrade the scheme.
+    bool upgrade_scheme = false;
+    std::unique_ptr<re2::RE2> from;
+    std::string to;
+  };
+
+  struct RuleSet {
+    RuleSet();
+    RuleSet(RuleSet&& other);
+    ~RuleSet();
+
+    std::vector<std::unique_ptr<re2::RE2>> exclusions;
+    // A ruleset without a valid "r" list stops evaluation, matching the
+    // behavior of the uncompiled JSON walk.
+    bool has_rules = false;
+    std::vector<Rule> rules;
+  };
+
+  HTTPSECompiledRuleSet();
+
+  std::vector<RuleSet> rulesets_;
+  size_t memory_usage_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSECompiledRuleSet);
+};
+
+// MRU cache of compiled rulesets keyed by the HTTPSE database domain key
+// (e.g. "com.digg.*"), bounded by the estimated memory of its entries.
+// Not thread safe, must be used on the HTTPSE task runner only.
+class HTTPSERuleCache {
+ public:
+  explicit HTTPSERuleCache(size_t max_memory_bytes);
+  ~HTTPSERuleCache();
+
+  // Returns the cached ruleset for |key| or nullptr if it isn't cached.
+  const HTTPSECompiledRuleSet* Get(const std::string& key);
+  // Takes ownership of |ruleset| and evicts the least recently used entries
+  // until the cache fits into its memory budget again. The new entry itself
+  // is kept until the next Put() or Clear().
+  void Put(const std::string& key,
+           std::unique_ptr<HTTPSECompiledRuleSet> ruleset);
+  void Clear();
+
+  size_t size() const { return cache_.size(); }
+  size_t memory_usage() const { return memory_usage_; }
+
+ private:
+  void EvictIfNeeded();
+
+  base::MRUCache<std::string, std::unique_ptr<HTTPSECompiledRuleSet>> cache_;
+  const size_t max_memory_bytes_;
+  size_t memory_usage_ = 0;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSERuleCache);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_CACHE_H_
@@ -0,0 +1,96 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include <memory>
+#include <string>
+
+#include "brave/components/brave_shields/browser/https_everywhere_rule_cache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+using brave_shields::HTTPSECompiledRuleSet;
+using brave_shields::HTTPSERuleCache;
+
+namespace {
+
+const char kRewriteRules[] = R"([{
+  "e": [{"p": "^http://www\\.example\\.com/skip/.*"}],
+  "r": [{"f": "^http://(www\\.)?example\\.com/", "t": "https://$1example.com/"}]
+}])";
+
+const char kUpgradeRules[] = R"([{"r": [{"d": 1}]}])";
+
+}  // namespace
+
+TEST(HTTPSEverywhereRuleCacheTest, ParseRejectsInvalidJSON) {
+  EXPECT_EQ(nullptr, HTTPSECompiledRuleSet::Parse("not json"));
+  EXPECT_EQ(nullptr, HTTPSECompiledRuleSet::Parse(R"({"r": []})"));
+}
+
+TEST(HTTPSEverywhereRuleCacheTest, ApplyRewriteRules) {
+  std::unique_ptr<HTTPSECompiledRuleSet> rules =
+      HTTPSECompiledRuleSet::Parse(kRewriteRules);
+  ASSERT_TRUE(rules);
+
+  EXPECT_EQ("https://www.example.com/page",
+            rules->Apply("http://www.example.com/page"));
+  EXPECT_EQ("https://example.com/", rules->Apply("http://example.com/"));
+  // Excluded URL.
+  EXPECT_EQ("", rules->Apply("http://www.example.com/skip/page"));
+  // Rule doesn't match.
+  EXPECT_EQ("", rules->Apply("http://sub.example.com/"));
+}
+
+TEST(HTTPSEverywhereRuleCacheTest, ApplyUpgradeRules) {
+  std::unique_ptr<HTTPSECompiledRuleSet> rules =
+      HTTPSECompiledRuleSet::Parse(kUpgradeRules);
+  ASSERT_TRUE(rules);
+  EXPECT_EQ("https://digg.com/", rules->Apply("http://digg.com/"));
+}
+
+TEST(HTTPSEverywhereRuleCacheTest, CorrecttoRuleToRE2Engine) {
+  EXPECT_EQ("https://\\1example.com/\\2",
+            HTTPSECompiledRuleSet::CorrecttoRuleToRE2Engine(
+                "https://$1example.com/$2"));
+}
+
+TEST(HTTPSEverywhereRuleCacheTest, EvictsByMemory) {
+  const size_t ruleset_size =
+      HTTPSECompiledRuleSet::Parse(kRewriteRules)->EstimateMemoryUsage();
+  HTTPSERuleCache cache(2 * ruleset_size + 64);
+
+  cache.Put("com.example", HTTPSECompiledRuleSet::Parse(kRewriteRules));
+  cache.Put("com.example.*", HTTPSECompiledRuleSet::Parse(kRewriteRules));
+  EXPECT_EQ(2u, cache.size());
+  // Touch the first entry so the second one is the least recently used.
+  EXPECT_TRUE(cache.Get("com.example"));
+
+  cache.Put("org.example", HTTPSECompiledRuleSet::Parse(kRewriteRules));
+  EXPECT_EQ(2u, cache.size());
+  EXPECT_LE(cache.memory_usage(), 2 * ruleset_size + 64);
+  EXPECT_TRUE(cache.Get("com.example"));
+  EXPECT_FALSE(cache.Get("com.example.*"));
+  EXPECT_TRUE(cache.Get("org.example"));
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.size());
+  EXPECT_EQ(0u, cache.memory_usage());
+}
+
+TEST(HTTPSEverywhereRuleCacheTest, KeepsNewestEntryOverBudget) {
+  HTTPSERuleCache cache(1);
+  cache.Put("com.example", HTTPSECompiledRuleSet::Parse(kRewriteRules));
+  cache.Put("org.example", HTTPSECompiledRuleSet::Parse(kRewriteRules));
+  EXPECT_EQ(1u, cache.size());
+  EXPECT_TRUE(cache.Get("org.example"));
+}
+
+TEST(HTTPSEverywhereRuleCacheTest, UpgradesAllURLs) {
+  EXPECT_TRUE(HTTPSECompiledRuleSet::Parse(kUpgradeRules)->UpgradesAllURLs());
+  EXPECT_FALSE(HTTPSECompiledRuleSet::Parse(kRewriteRules)->UpgradesAllURLs());
+  // Exclusions make the result depend on the path.
+  EXPECT_FALSE(HTTPSECompiledRuleSet::Parse(
+                   R"([{"e": [{"p": "^http://a\\.com/x"}], "r": [{"d": 1}]}])")
+                   ->UpgradesAllURLs());
+}
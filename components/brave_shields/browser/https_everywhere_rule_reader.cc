@@ -0,0 +1,209 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_rule_reader.h"
+
+#include <utility>
+
+#include "base/big_endian.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/memory/ptr_util.h"
+#include "third_party/leveldatabase/src/include/leveldb/db.h"
+#include "third_party/leveldatabase/src/include/leveldb/iterator.h"
+
+namespace brave_shields {
+
+namespace {
+
+constexpr char kIndexMagic[] = "HTTPSEIX";
+constexpr size_t kIndexMagicSize = sizeof(kIndexMagic) - 1;
+constexpr uint32_t kIndexVersion = 1;
+constexpr size_t kHeaderSize = kIndexMagicSize + 2 * sizeof(uint32_t);
+constexpr size_t kEntryFieldCount = 4;
+constexpr size_t kEntrySize = kEntryFieldCount * sizeof(uint32_t);
+
+enum EntryFields {
+  kKeyOffset = 0,
+  kKeyLength,
+  kValueOffset,
+  kValueLength,
+};
+
+void AppendUint32(uint32_t value, std::string* out) {
+  char buffer[sizeof(uint32_t)];
+  base::WriteBigEndian(buffer, value);
+  out->append(buffer, sizeof(buffer));
+}
+
+}  // namespace
+
+// static
+std::unique_ptr<HTTPSELevelDBRuleReader> HTTPSELevelDBRuleReader::Open(
+    const base::FilePath& db_path) {
+  leveldb::DB* db = nullptr;
+  leveldb::Options options;
+  leveldb::Status status =
+      leveldb::DB::Open(options, db_path.AsUTF8Unsafe(), &db);
+  if (!status.ok() || !db) {
+    LOG(ERROR) << "Level db open error " << db_path.value().c_str()
+               << ", error: " << status.ToString();
+    delete db;
+    return nullptr;
+  }
+  return base::WrapUnique(
+      new HTTPSELevelDBRuleReader(base::WrapUnique(db)));
+}
+
+HTTPSELevelDBRuleReader::HTTPSELevelDBRuleReader(
+    std::unique_ptr<leveldb::DB> db)
+    : db_(std::move(db)) {}
+
+HTTPSELevelDBRuleReader::~HTTPSELevelDBRuleReader() = default;
+
+bool HTTPSELevelDBRuleReader::Get(const std::string& key,
+                                  std::string* value) const {
+  leveldb::Status s = db_->Get(leveldb::ReadOptions(), key, value);
+  return s.ok() && !value->empty();
+}
+
+bool HTTPSELevelDBRuleReader::ReadAll(
+    std::map<std::string, std::string>* rules) const {
+  std::unique_ptr<leveldb::Iterator> it(
+      db_->NewIterator(leveldb::ReadOptions()));
+  for (it->SeekToFirst(); it->Valid(); it->Next())
+    (*rules)[it->key().ToString()] = it->value().ToString();
+  return it->status().ok();
+}
+
+// static
+std::unique_ptr<HTTPSEIndexRuleReader> HTTPSEIndexRuleReader::Open(
+    const base::FilePath& index_path) {
+  auto reader = base::WrapUnique(new HTTPSEIndexRuleReader());
+  if (!reader->Initialize(index_path))
+    return nullptr;
+  return reader;
+}
+
+// static
+std::string HTTPSEIndexRuleReader::Serialize(
+    const std::map<std::string, std::string>& rules) {
+  std::string table;
+  std::string blob;
+  for (const auto& rule : rules) {
+    AppendUint32(blob.size(), &table);
+    AppendUint32(rule.first.size(), &table);
+    blob.append(rule.first);
+    AppendUint32(blob.size(), &table);
+    AppendUint32(rule.second.size(), &table);
+    blob.append(rule.second);
+  }
+
+  std::string out(kIndexMagic, kIndexMagicSize);
+  AppendUint32(kIndexVersion, &out);
+  AppendUint32(rules.size(), &out);
+  out.append(table);
+  out.append(blob);
+  return out;
+}
+
+HTTPSEIndexRuleReader::HTTPSEIndexRuleReader() = default;
+
+HTTPSEIndexRuleReader::~HTTPSEIndexRuleReader() = default;
+
+bool HTTPSEIndexRuleReader::Initialize(const base::FilePath& index_path) {
+  if (!file_.Initialize(index_path))
+    return false;
+
+  const char* data = reinterpret_cast<const char*>(file_.data());
+  const size_t length = file_.length();
+  if (length < kHeaderSize ||
+      base::StringPiece(data, kIndexMagicSize) != kIndexMagic) {
+    LOG(ERROR) << "Invalid HTTPSE index " << index_path.value().c_str();
+    return false;
+  }
+
+  uint32_t version = 0;
+  uint32_t entry_count = 0;
+  base::ReadBigEndian(data + kIndexMagicSize, &version);
+  base::ReadBigEndian(data + kIndexMagicSize + sizeof(uint32_t), &entry_count);
+  if (version != kIndexVersion ||
+      (length - kHeaderSize) / kEntrySize < entry_count) {
+    LOG(ERROR) << "Unsupported HTTPSE index " << index_path.value().c_str();
+    return false;
+  }
+
+  entries_ = data + kHeaderSize;
+  entry_count_ = entry_count;
+  blob_ = entries_ + entry_count_ * kEntrySize;
+  const size_t blob_size = data + length - blob_;
+
+  // Validate the whole table once so lookups don't need bounds checks.
+  for (size_t i = 0; i < entry_count_; ++i) {
+    const uint64_t key_end =
+        static_cast<uint64_t>(EntryField(i, kKeyOffset)) +
+        EntryField(i, kKeyLength);
+    const uint64_t value_end =
+        static_cast<uint64_t>(EntryField(i, kValueOffset)) +
+        EntryField(i, kValueLength);
+    if (key_end > blob_size || value_end > blob_size ||
+        (i > 0 && !(KeyAt(i - 1) < KeyAt(i)))) {
+      LOG(ERROR) << "Corrupted HTTPSE index " << index_path.value().c_str();
+      entries_ = nullptr;
+      entry_count_ = 0;
+      blob_ = nullptr;
+      return false;
+    }
+  }
+  return true;
+}
+
+uint32_t HTTPSEIndexRuleReader::EntryField(size_t index, size_t field) const {
+  DCHECK_LT(index, entry_count_);
+  uint32_t value = 0;
+  base::ReadBigEndian(
+      entries_ + index * kEntrySize + field * sizeof(uint32_t), &value);
+  return value;
+}
+
+base::StringPiece HTTPSEIndexRuleReader::KeyAt(size_t index) const {
+  return base::StringPiece(blob_ + EntryField(index, kKeyOffset),
+                           EntryField(index, kKeyLength));
+}
+
+base::StringPiece HTTPSEIndexRuleReader::ValueAt(size_t index) const {
+  return base::StringPiece(blob_ + EntryField(index, kValueOffset),
+                           EntryField(index, kValueLength));
+}
+
+bool HTTPSEIndexRuleReader::Find(base::StringPiece key,
+                                 base::StringPiece* value) const {
+  size_t low = 0;
+  size_t high = entry_count_;
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    const int compare = KeyAt(mid).compare(key);
+    if (compare == 0) {
+      *value = ValueAt(mid);
+      return !value->empty();
+    }
+    if (compare < 0)
+      low = mid + 1;
+    else
+      high = mid;
+  }
+  return false;
+}
+
+bool HTTPSEIndexRuleReader::Get(const std::string& key,
+                                std::string* value) const {
+  base::StringPiece found;
+  if (!Find(key, &found))
+    return false;
+  value->assign(found.data(), found.size());
+  return true;
+}
+
+}  // namespace brave_shields
@@ -0,0 +1,104 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_READER_H_
+#define BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_READER_H_
+
+#include <map>
+#include <memory>
+#include <string>
+
+#include "base/files/memory_mapped_file.h"
+#include "base/macros.h"
+#include "base/strings/string_piece.h"
+
+namespace base {
+class FilePath;
+}  // namespace base
+
+namespace leveldb {
+class DB;
+}  // namespace leveldb
+
+namespace brave_shields {
+
+// Looks up the JSON rules stored under a reversed domain key such as
+// "com.digg.*" in an HTTPSE dataset.
+class HTTPSERuleReader {
+ public:
+  virtual ~HTTPSERuleReader() = default;
+
+  // Returns false if there are no rules for |key|.
+  virtual bool Get(const std::string& key, std::string* value) const = 0;
+};
+
+// Reads rules from the legacy zipped leveldb dataset.
+class HTTPSELevelDBRuleReader : public HTTPSERuleReader {
+ public:
+  // Opens an already unzipped leveldb directory. Returns nullptr on error.
+  static std::unique_ptr<HTTPSELevelDBRuleReader> Open(
+      const base::FilePath& db_path);
+  ~HTTPSELevelDBRuleReader() override;
+
+  // Copies every key/value pair of the database into |rules|.
+  bool ReadAll(std::map<std::string, std::string>* rules) const;
+
+  // HTTPSERuleReader:
+  bool Get(const std::string& key, std::string* value) const override;
+
+ private:
+  explicit HTTPSELevelDBRuleReader(std::unique_ptr<leveldb::DB> db);
+
+  std::unique_ptr<leveldb::DB> db_;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSELevelDBRuleReader);
+};
+
+// Reads rules from a flat, read-only index file which is memory mapped so no
+// unzip step or leveldb instance is needed. The file consists of a header,
+// a table of fixed size entries sorted by key and a blob with all keys and
+// values. All integers are big endian uint32:
+//
+//   "HTTPSEIX" | version | entry count
+//   { key offset | key length | value offset | value length } * entry count
+//   keys and values, offsets are relative to the start of this blob
+class HTTPSEIndexRuleReader : public HTTPSERuleReader {
+ public:
+  // Maps and validates the index at |index_path|. Returns nullptr if the
+  // file is missing or malformed.
+  static std::unique_ptr<HTTPSEIndexRuleReader> Open(
+      const base::FilePath& index_path);
+  ~HTTPSEIndexRuleReader() override;
+
+  // Builds the contents of an index file from |rules|.
+  static std::string Serialize(const std::map<std::string, std::string>& rules);
+
+  // Returns a view into the mapped file, valid for the reader's lifetime.
+  bool Find(base::StringPiece key, base::StringPiece* value) const;
+
+  size_t size() const { return entry_count_; }
+
+  // HTTPSERuleReader:
+  bool Get(const std::string& key, std::string* value) const override;
+
+ private:
+  HTTPSEIndexRuleReader();
+  bool Initialize(const base::FilePath& index_path);
+  // Reads the |field|th uint32 of the |index|th entry.
+  uint32_t EntryField(size_t index, size_t field) const;
+  base::StringPiece KeyAt(size_t index) const;
+  base::StringPiece ValueAt(size_t index) const;
+
+  base::MemoryMappedFile file_;
+  const char* entries_ = nullptr;
+  size_t entry_count_ = 0;
+  const char* blob_ = nullptr;
+
+  DISALLOW_COPY_AND_ASSIGN(HTTPSEIndexRuleReader);
+};
+
+}  // namespace brave_shields
+
+#endif  // BRAVE_COMPONENTS_BRAVE_SHIELDS_BROWSER_HTTPS_EVERYWHERE_RULE_READER_H_
@@ -0,0 +1,127 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/brave_shields/browser/https_everywhere_rule_reader.h"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/files/scoped_temp_dir.h"
+#include "base/path_service.h"
+#include "brave/common/brave_paths.h"
+#include "brave/components/brave_shields/browser/https_everywhere_rule_cache.h"
+#include "testing/gtest/include/gtest/gtest.h"
+#include "third_party/zlib/google/zip.h"
+
+namespace brave_shields {
+
+namespace {
+
+// Mirrors the lookup done by HTTPSEverywhereService::GetHTTPSURL for the
+// given reversed domain keys.
+std::string GetRedirect(const HTTPSERuleReader& reader,
+                        const std::vector<std::string>& keys,
+                        const std::string& url) {
+  for (const auto& key : keys) {
+    std::string value;
+    if (!reader.Get(key, &value))
+      continue;
+    std::unique_ptr<HTTPSECompiledRuleSet> rules =
+        HTTPSECompiledRuleSet::Parse(value);
+    if (!rules)
+      continue;
+    std::string new_url = rules->Apply(url);
+    if (!new_url.empty())
+      return new_url;
+  }
+  return "";
+}
+
+}  // namespace
+
+class HTTPSEverywhereRuleReaderTest : public testing::Test {
+ public:
+  void SetUp() override {
+    ASSERT_TRUE(temp_dir_.CreateUniqueTempDir());
+
+    base::FilePath test_data_dir;
+    ASSERT_TRUE(base::PathService::Get(brave::DIR_TEST_DATA, &test_data_dir));
+    base::FilePath zip_path =
+        test_data_dir.AppendASCII("https-everywhere-data")
+            .AppendASCII("6.0")
+            .AppendASCII("httpse.leveldb.zip");
+    ASSERT_TRUE(zip::Unzip(zip_path, temp_dir_.GetPath()));
+
+    leveldb_reader_ = HTTPSELevelDBRuleReader::Open(
+        temp_dir_.GetPath().AppendASCII("httpse.leveldb"));
+    ASSERT_TRUE(leveldb_reader_);
+
+    ASSERT_TRUE(leveldb_reader_->ReadAll(&rules_));
+    ASSERT_FALSE(rules_.empty());
+
+    base::FilePath index_path =
+        temp_dir_.GetPath().AppendASCII("httpse.index");
+    const std::string index = HTTPSEIndexRuleReader::Serialize(rules_);
+    ASSERT_EQ(static_cast<int>(index.size()),
+              base::WriteFile(index_path, index.data(), index.size()));
+    index_reader_ = HTTPSEIndexRuleReader::Open(index_path);
+    ASSERT_TRUE(index_reader_);
+  }
+
+ protected:
+  base::ScopedTempDir temp_dir_;
+  std::map<std::string, std::string> rules_;
+  std::unique_ptr<HTTPSELevelDBRuleReader> leveldb_reader_;
+  std::unique_ptr<HTTPSEIndexRuleReader> index_reader_;
+};
+
+TEST_F(HTTPSEverywhereRuleReaderTest, BackendsReturnSameRules) {
+  EXPECT_EQ(rules_.size(), index_reader_->size());
+  for (const auto& rule : rules_) {
+    std::string leveldb_value;
+    std::string index_value;
+    EXPECT_EQ(leveldb_reader_->Get(rule.first, &leveldb_value),
+              index_reader_->Get(rule.first, &index_value));
+    EXPECT_EQ(leveldb_value, index_value);
+  }
+
+  std::string value;
+  EXPECT_FALSE(index_reader_->Get("com.brianbondy.www", &value));
+  EXPECT_FALSE(index_reader_->Get("", &value));
+}
+
+TEST_F(HTTPSEverywhereRuleReaderTest, BackendsReturnSameRedirect) {
+  const std::vector<std::string> digg_keys = {"com.digg.www", "com.digg.*"};
+  const std::string leveldb_redirect =
+      GetRedirect(*leveldb_reader_, digg_keys, "http://www.digg.com/");
+  EXPECT_EQ("https://www.digg.com/", leveldb_redirect);
+  EXPECT_EQ(leveldb_redirect,
+            GetRedirect(*index_reader_, digg_keys, "http://www.digg.com/"));
+
+  const std::vector<std::string> unknown_keys = {"com.brianbondy.www",
+                                                 "com.brianbondy.*"};
+  EXPECT_EQ("", GetRedirect(*leveldb_reader_, unknown_keys,
+                            "http://www.brianbondy.com/"));
+  EXPECT_EQ("", GetRedirect(*index_reader_, unknown_keys,
+                            "http://www.brianbondy.com/"));
+}
+
+TEST_F(HTTPSEverywhereRuleReaderTest, RejectsCorruptedIndex) {
+  base::FilePath index_path = temp_dir_.GetPath().AppendASCII("bad.index");
+  std::string index = HTTPSEIndexRuleReader::Serialize(rules_);
+  // Drop the blob so the entry offsets point past the end of the file.
+  index.resize(index.size() / 2);
+  ASSERT_EQ(static_cast<int>(index.size()),
+            base::WriteFile(index_path, index.data(), index.size()));
+  EXPECT_FALSE(HTTPSEIndexRuleReader::Open(index_path));
+  EXPECT_FALSE(HTTPSEIndexRuleReader::Open(
+      temp_dir_.GetPath().AppendASCII("missing.index")));
+}
+
+}  // namespace brave_shields
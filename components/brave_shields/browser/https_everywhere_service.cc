@@ -6,27 +6,31 @@
 #include "brave/components/brave_shields/browser/https_everywhere_service.h"
 
 #include <algorithm>
+#include <map>
 #include <string>
 #include <utility>
 #include <vector>
 
 #include "base/base_paths.h"
 #include "base/bind.h"
-#include "base/json/json_reader.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
 #include "base/logging.h"
 #include "base/macros.h"
 #include "base/memory/ptr_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/threading/scoped_blocking_call.h"
-#include "base/values.h"
-#include "third_party/leveldatabase/src/include/leveldb/db.h"
-#include "third_party/re2/src/re2/re2.h"
 #include "third_party/zlib/google/zip.h"
 
 #define DAT_FILE "httpse.leveldb.zip"
 #define DAT_FILE_VERSION "6.0"
+#define INDEX_FILE "httpse.index"
 #define HTTPSE_URLS_REDIRECTS_COUNT_QUEUE   1
 #define HTTPSE_URL_MAX_REDIRECTS_COUNT      5
+#define HTTPSE_RULE_CACHE_MAX_MEMORY_BYTES  (4 * 1024 * 1024)
+#define HTTPSE_URL_CACHE_SIZE               1024
+#define HTTPSE_HOST_CACHE_SIZE              1024
+#define HTTPSE_CACHE_SHARD_COUNT            16
 
 namespace {
 
@@ -65,15 +69,6 @@ std::vector<std::string> ExpandDomainForLookup(const std::string& domain) {
   }
   return resultDomains;
 }
-std::string leveldbGet(leveldb::DB* db, const std::string &key) {
-  if (!db) {
-    return "";
-  }
-
-  std::string value;
-  leveldb::Status s = db->Get(leveldb::ReadOptions(), key, &value);
-  return s.ok() ? value : "";
-}
 
 }  // namespace
 
@@ -100,12 +95,15 @@ HTTPSEverywhereService::g_https_everywhere_component_base64_public_key_(
 HTTPSEverywhereService::HTTPSEverywhereService(
     BraveComponent::Delegate* delegate)
     : BaseBraveShieldsService(delegate),
-      level_db_(nullptr) {
+      recently_used_cache_(HTTPSE_URL_CACHE_SIZE, HTTPSE_CACHE_SHARD_COUNT),
+      host_cache_(HTTPSE_HOST_CACHE_SIZE, HTTPSE_CACHE_SHARD_COUNT),
+      rule_cache_(HTTPSE_RULE_CACHE_MAX_MEMORY_BYTES) {
   DETACH_FROM_SEQUENCE(sequence_checker_);
 }
 
 HTTPSEverywhereService::~HTTPSEverywhereService() {
-  GetTaskRunner()->DeleteSoon(FROM_HERE, level_db_);
+  if (rule_reader_)
+    GetTaskRunner()->DeleteSoon(FROM_HERE, rule_reader_.release());
 }
 
 bool HTTPSEverywhereService::Init() {
@@ -117,6 +115,20 @@ bool HTTPSEverywhereService::Init() {
 
 void HTTPSEverywhereService::InitDB(const base::FilePath& install_dir) {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  // Prefer the memory mapped index, which needs neither an unzip step nor a
+  // leveldb instance, and fall back to the zipped leveldb dataset.
+  base::FilePath index_file_path =
+      install_dir.AppendASCII(DAT_FILE_VERSION).AppendASCII(INDEX_FILE);
+  if (base::PathExists(index_file_path)) {
+    std::unique_ptr<HTTPSEIndexRuleReader> index_reader =
+        HTTPSEIndexRuleReader::Open(index_file_path);
+    if (index_reader) {
+      CloseDatabase();
+      rule_reader_ = std::move(index_reader);
+      return;
+    }
+  }
+
   base::FilePath zip_db_file_path =
       install_dir.AppendASCII(DAT_FILE_VERSION).AppendASCII(DAT_FILE);
   base::FilePath unzipped_level_db_path = zip_db_file_path.RemoveExtension();
@@ -128,19 +140,27 @@ void HTTPSEverywhereService::InitDB(const base::FilePath& install_dir) {
   }
 
   CloseDatabase();
-
-  leveldb::Options options;
-  leveldb::Status status =
-      leveldb::DB::Open(options,
-                        unzipped_level_db_path.AsUTF8Unsafe(),
-                        &level_db_);
-  if (!status.ok() || !level_db_) {
-    LOG(ERROR) << "Level db open error "
-               << unzipped_level_db_path.value().c_str()
-               << ", error: " << status.ToString();
-    CloseDatabase();
+  std::unique_ptr<HTTPSELevelDBRuleReader> level_db_reader =
+      HTTPSELevelDBRuleReader::Open(unzipped_level_db_path);
+  if (!level_db_reader)
     return;
+
+  // Build the index next to the dataset, so that the next start of the
+  // browser can skip the unzip step and leveldb altogether.
+  std::map<std::string, std::string> rules;
+  if (level_db_reader->ReadAll(&rules) &&
+      base::ImportantFileWriter::WriteFileAtomically(
+          index_file_path, HTTPSEIndexRuleReader::Serialize(rules))) {
+    std::unique_ptr<HTTPSEIndexRuleReader> index_reader =
+        HTTPSEIndexRuleReader::Open(index_file_path);
+    if (index_reader) {
+      rule_reader_ = std::move(index_reader);
+      return;
+    }
   }
+  LOG(ERROR) << "Failed to build HTTPSE index "
+             << index_file_path.value().c_str();
+  rule_reader_ = std::move(level_db_reader);
 }
 
 void HTTPSEverywhereService::OnComponentReady(
@@ -163,38 +183,45 @@ bool HTTPSEverywhereService::GetHTTPSURL(
   if (!url->is_valid())
     return false;
 
-  if (!IsInitialized() || !level_db_ || url->scheme() == url::kHttpsScheme) {
+  if (!IsInitialized() || !rule_reader_ ||
+      url->scheme() == url::kHttpsScheme) {
     return false;
   }
   if (!ShouldHTTPSERedirect(request_identifier)) {
     return false;
   }
 
-  if (recently_used_cache_.get(url->spec(), new_url)) {
+  const GURL candidate_url = GetCandidateURL(*url);
+  if (GetCachedHTTPSURL(candidate_url, new_url)) {
+    if (new_url->empty())
+      return false;
     AddHTTPSEUrlToRedirectList(request_identifier);
     return true;
   }
 
-  GURL candidate_url(*url);
-  if (g_ignore_port_for_test_ && candidate_url.has_port()) {
-    GURL::Replacements replacements;
-    replacements.ClearPort();
-    candidate_url = candidate_url.ReplaceComponents(replacements);
-  }
-
+  bool has_rules = false;
   const std::vector<std::string> domains =
       ExpandDomainForLookup(candidate_url.host());
-  for (auto domain : domains) {
-    std::string value = leveldbGet(level_db_, domain);
-    if (!value.empty()) {
-      *new_url = ApplyHTTPSRule(candidate_url.spec(), value);
-      if (0 != new_url->length()) {
+  for (const auto& domain : domains) {
+    const HTTPSECompiledRuleSet* rules = GetCompiledRules(domain);
+    if (!rules)
+      continue;
+    // Only the first matching ruleset decides whether the result holds for
+    // every path on the host, later ones are never reached in that case.
+    const bool upgrades_host = !has_rules && rules->UpgradesAllURLs();
+    has_rules = true;
+    *new_url = rules->Apply(candidate_url.spec());
+    if (0 != new_url->length()) {
+      if (upgrades_host)
+        host_cache_.add(candidate_url.host(), true);
+      else
         recently_used_cache_.add(candidate_url.spec(), *new_url);
-        AddHTTPSEUrlToRedirectList(request_identifier);
-        return true;
-      }
+      AddHTTPSEUrlToRedirectList(request_identifier);
+      return true;
     }
   }
+  if (!has_rules)
+    host_cache_.add(candidate_url.host(), false);
   recently_used_cache_.remove(candidate_url.spec());
   return false;
 }
@@ -213,13 +240,37 @@ bool HTTPSEverywhereService::GetHTTPSURLFromCacheOnly(
     return false;
   }
 
-  if (recently_used_cache_.get(url->spec(), cached_url)) {
-    AddHTTPSEUrlToRedirectList(request_identifier);
+  if (GetCachedHTTPSURL(GetCandidateURL(*url), cached_url)) {
+    if (!cached_url->empty())
+      AddHTTPSEUrlToRedirectList(request_identifier);
     return true;
   }
   return false;
 }
 
+GURL HTTPSEverywhereService::GetCandidateURL(const GURL& url) const {
+  if (!g_ignore_port_for_test_ || !url.has_port())
+    return url;
+  GURL::Replacements replacements;
+  replacements.ClearPort();
+  return url.ReplaceComponents(replacements);
+}
+
+bool HTTPSEverywhereService::GetCachedHTTPSURL(const GURL& candidate_url,
+                                               std::string* new_url) {
+  bool upgrades_host = false;
+  if (host_cache_.get(candidate_url.host(), &upgrades_host)) {
+    if (upgrades_host) {
+      *new_url = candidate_url.spec();
+      new_url->insert(4, "s");
+    } else {
+      new_url->clear();
+    }
+    return true;
+  }
+  return recently_used_cache_.get(candidate_url.spec(), new_url);
+}
+
 bool HTTPSEverywhereService::ShouldHTTPSERedirect(
     const uint64_t& request_identifier) {
   base::AutoLock auto_lock(httpse_get_urls_redirects_count_mutex_);
@@ -262,124 +313,34 @@ void HTTPSEverywhereService::AddHTTPSEUrlToRedirectList(
   }
 }
 
-std::string HTTPSEverywhereService::ApplyHTTPSRule(
-    const std::string& originalUrl,
-    const std::string& rule) {
-  base::Optional<base::Value> json_object = base::JSONReader::Read(rule);
-  if (base::nullopt == json_object || !json_object->is_list()) {
-    return "";
-  }
-
-  base::Value::ConstListView topValues = json_object->GetList();
-  for (auto it = topValues.cbegin(); it != topValues.cend(); ++it) {
-    if (!it->is_dict()) {
-      continue;
-    }
-    const base::DictionaryValue* childTopDictionary = nullptr;
-    it->GetAsDictionary(&childTopDictionary);
-    if (nullptr == childTopDictionary) {
-      continue;
-    }
-
-    const base::Value* exclusion = nullptr;
-    if (childTopDictionary->Get("e", &exclusion)) {
-      const base::ListValue* eValues = nullptr;
-      exclusion->GetAsList(&eValues);
-      if (nullptr != eValues) {
-        for (size_t j = 0; j < eValues->GetSize(); ++j) {
-          const base::Value* pValue = nullptr;
-          if (!eValues->Get(j, &pValue)) {
-            continue;
-          }
-          const base::DictionaryValue* pDictionary = nullptr;
-          pValue->GetAsDictionary(&pDictionary);
-          if (nullptr == pDictionary) {
-            continue;
-          }
-          const base::Value* patternValue = nullptr;
-          if (!pDictionary->Get("p", &patternValue)) {
-            continue;
-          }
-          std::string pattern;
-          if (!patternValue->GetAsString(&pattern)) {
-            continue;
-          }
-          pattern = CorrecttoRuleToRE2Engine(pattern);
-          if (RE2::FullMatch(originalUrl, pattern)) {
-            return "";
-          }
-        }
-      }
-    }
-
-    const base::Value* rules = nullptr;
-    if (!childTopDictionary->Get("r", &rules)) {
-      return "";
-    }
-    const base::ListValue* rValues = nullptr;
-    rules->GetAsList(&rValues);
-    if (nullptr == rValues) {
-      return "";
-    }
-
-    for (size_t j = 0; j < rValues->GetSize(); ++j) {
-      const base::Value* pValue = nullptr;
-      if (!rValues->Get(j, &pValue)) {
-        continue;
-      }
-      const base::DictionaryValue* pDictionary = nullptr;
-      pValue->GetAsDictionary(&pDictionary);
-      if (nullptr == pDictionary) {
-        continue;
-      }
-      const base::Value* patternValue = nullptr;
-      if (pDictionary->Get("d", &patternValue)) {
-        std::string newUrl(originalUrl);
-        return newUrl.insert(4, "s");
-      }
-
-      const base::Value* from_value = nullptr;
-      const base::Value* to_value = nullptr;
-      if (!pDictionary->Get("f", &from_value) ||
-          !pDictionary->Get("t", &to_value)) {
-        continue;
-      }
-      std::string from, to;
-      if (!from_value->GetAsString(&from) ||
-          !to_value->GetAsString(&to)) {
-        continue;
-      }
-
-      to = CorrecttoRuleToRE2Engine(to);
-      std::string newUrl(originalUrl);
-      RE2 regExp(from);
+const HTTPSECompiledRuleSet* HTTPSEverywhereService::GetCompiledRules(
+    const std::string& domain) {
+  DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+  const HTTPSECompiledRuleSet* cached = rule_cache_.Get(domain);
+  if (cached)
+    return cached;
 
-      if (RE2::Replace(&newUrl, regExp, to) && newUrl != originalUrl) {
-        return newUrl;
-      }
-    }
-  }
-  return "";
-}
+  std::string value;
+  if (!rule_reader_ || !rule_reader_->Get(domain, &value))
+    return nullptr;
 
-std::string HTTPSEverywhereService::CorrecttoRuleToRE2Engine(
-    const std::string& to) {
-  std::string correctedto(to);
-  size_t pos = to.find("$");
-  while (std::string::npos != pos) {
-    correctedto[pos] = '\\';
-    pos = correctedto.find("$");
-  }
+  std::unique_ptr<HTTPSECompiledRuleSet> compiled =
+      HTTPSECompiledRuleSet::Parse(value);
+  if (!compiled)
+    return nullptr;
 
-  return correctedto;
+  const HTTPSECompiledRuleSet* result = compiled.get();
+  rule_cache_.Put(domain, std::move(compiled));
+  return result;
 }
 
 void HTTPSEverywhereService::CloseDatabase() {
   DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
-  if (level_db_) {
-    delete level_db_;
-    level_db_ = nullptr;
-  }
+  rule_reader_.reset();
+  // Compiled rules and cached results belong to the previous dataset.
+  rule_cache_.Clear();
+  recently_used_cache_.clear();
+  host_cache_.clear();
 }
 
 // static
@@ -16,10 +16,9 @@
 #include "base/synchronization/lock.h"
 #include "brave/components/brave_shields/browser/base_brave_shields_service.h"
 #include "brave/components/brave_shields/browser/https_everywhere_recently_used_cache.h"
-
-namespace leveldb {
-class DB;
-}
+#include "brave/components/brave_shields/browser/https_everywhere_rule_cache.h"
+#include "brave/components/brave_shields/browser/https_everywhere_rule_reader.h"
+#include "url/gurl.h"
 
 class HTTPSEverywhereServiceTest;
 
@@ -51,6 +50,8 @@ class HTTPSEverywhereService : public BaseBraveShieldsService,
   bool GetHTTPSURL(const GURL* url,
                    const uint64_t& request_id,
                    std::string* new_url);
+  // Returns true if the result for |url| is cached, in which case
+  // |cached_url| is left empty if |url| is known not to be redirected.
   bool GetHTTPSURLFromCacheOnly(const GURL* url,
                                 const uint64_t& request_id,
                                 std::string* cached_url);
@@ -63,9 +64,10 @@ class HTTPSEverywhereService : public BaseBraveShieldsService,
 
   void AddHTTPSEUrlToRedirectList(const uint64_t& request_id);
   bool ShouldHTTPSERedirect(const uint64_t& request_id);
-  std::string ApplyHTTPSRule(const std::string& originalUrl,
-      const std::string& rule);
-  std::string CorrecttoRuleToRE2Engine(const std::string& to);
+  // Returns the compiled rules stored under |domain|, reading and compiling
+  // them from the database on a cache miss. The pointer is only valid until
+  // the next lookup.
+  const HTTPSECompiledRuleSet* GetCompiledRules(const std::string& domain);
 
  private:
   friend class ::HTTPSEverywhereServiceTest;
@@ -79,12 +81,22 @@ class HTTPSEverywhereService : public BaseBraveShieldsService,
 
   void CloseDatabase();
 
+  GURL GetCandidateURL(const GURL& url) const;
+  // Looks up |candidate_url| in the host and URL caches. Returns true on a
+  // hit and leaves |new_url| empty if there is no redirect.
+  bool GetCachedHTTPSURL(const GURL& candidate_url, std::string* new_url);
+
   void InitDB(const base::FilePath& install_dir);
 
   base::Lock httpse_get_urls_redirects_count_mutex_;
   std::vector<HTTPSE_REDIRECTS_COUNT_ST> httpse_urls_redirects_count_;
+  // Results which depend on the full URL, keyed by URL spec.
   HTTPSERecentlyUsedCache<std::string> recently_used_cache_;
-  leveldb::DB* level_db_;
+  // Hosts whose rules upgrade every URL (true) or which have no rules at
+  // all (false), keyed by host.
+  HTTPSERecentlyUsedCache<bool> host_cache_;
+  HTTPSERuleCache rule_cache_;
+  std::unique_ptr<HTTPSERuleReader> rule_reader_;
 
   SEQUENCE_CHECKER(sequence_checker_);
   DISALLOW_COPY_AND_ASSIGN(HTTPSEverywhereService);
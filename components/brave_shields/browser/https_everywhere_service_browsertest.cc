@@ -3,6 +3,7 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this file,
  * You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include "base/files/file_util.h"
 #include "base/task/post_task.h"
 #include "base/path_service.h"
 #include "base/test/thread_test_helper.h"
@@ -141,3 +142,34 @@ IN_PROC_BROWSER_TEST_F(HTTPSEverywhereServiceTest, RedirectsKnownSiteInIframe) {
   EXPECT_EQ(GURL("https://www.digg.com/"),
             iframe_contents->GetLastCommittedURL());
 }
+
+// The first load builds the rule index from the leveldb dataset, and later
+// loads use the index.
+IN_PROC_BROWSER_TEST_F(HTTPSEverywhereServiceTest, BuildsAndUsesRuleIndex) {
+  base::FilePath test_data_dir;
+  GetTestDataDir(&test_data_dir);
+  const extensions::Extension* httpse_extension =
+      InstallExtension(test_data_dir.AppendASCII("https-everywhere-data"), 1);
+  ASSERT_TRUE(httpse_extension);
+  const base::FilePath index_path =
+      httpse_extension->path().AppendASCII("6.0").AppendASCII("httpse.index");
+
+  auto* service = g_brave_browser_process->https_everywhere_service();
+  service->OnComponentReady(httpse_extension->id(), httpse_extension->path(),
+                            "");
+  WaitForHTTPSEverywhereServiceThread();
+  {
+    base::ScopedAllowBlockingForTesting allow_blocking;
+    ASSERT_TRUE(base::PathExists(index_path));
+  }
+
+  service->OnComponentReady(httpse_extension->id(), httpse_extension->path(),
+                            "");
+  WaitForHTTPSEverywhereServiceThread();
+
+  GURL url = embedded_test_server()->GetURL("www.digg.com", "/");
+  ui_test_utils::NavigateToURL(browser(), url);
+  content::WebContents* contents =
+      browser()->tab_strip_model()->GetActiveWebContents();
+  EXPECT_EQ(GURL("https://www.digg.com/"), contents->GetLastCommittedURL());
+}
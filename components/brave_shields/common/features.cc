@@ -14,5 +14,11 @@ const base::Feature kBraveAdblockCosmeticFiltering{
     "BraveAdblockCosmeticFiltering",
     base::FEATURE_ENABLED_BY_DEFAULT};
 
+// Matches network requests against a single engine built from the default,
+// enabled regional and custom filter lists instead of one engine per list.
+const base::Feature kBraveAdblockCombinedEngine{
+    "BraveAdblockCombinedEngine",
+    base::FEATURE_DISABLED_BY_DEFAULT};
+
 }  // namespace features
 }  // namespace brave_shields
@@ -7,7 +7,6 @@
 
 #include <utility>
 
-#include "base/json/json_reader.h"
 #include "base/optional.h"
 #include "base/values.h"
 #include "brave/components/brave_shields/browser/ad_block_service.h"
@@ -26,42 +25,14 @@ CosmeticFiltersResources::CosmeticFiltersResources(
 CosmeticFiltersResources::~CosmeticFiltersResources() {}
 
 void CosmeticFiltersResources::HiddenClassIdSelectors(
-    const std::string& input,
+    const std::vector<std::string>& classes,
+    const std::vector<std::string>& ids,
     const std::vector<std::string>& exceptions,
     HiddenClassIdSelectorsCallback callback) {
-  base::Optional<base::Value> input_value = base::JSONReader::Read(input);
-  if (!input_value || !input_value->is_dict()) {
-    // Nothing to work with
-    std::move(callback).Run(base::Value());
-
-    return;
-  }
-  base::DictionaryValue* input_dict;
-  if (!input_value->GetAsDictionary(&input_dict)) {
-    std::move(callback).Run(base::Value());
-
+  if (classes.empty() && ids.empty()) {
+    std::move(callback).Run(base::Value(base::Value::Type::LIST));
     return;
   }
-  std::vector<std::string> classes;
-  base::ListValue* classes_list;
-  if (input_dict->GetList("classes", &classes_list)) {
-    for (size_t i = 0; i < classes_list->GetSize(); i++) {
-      if (!classes_list->GetList()[i].is_string()) {
-        continue;
-      }
-      classes.push_back(classes_list->GetList()[i].GetString());
-    }
-  }
-  std::vector<std::string> ids;
-  base::ListValue* ids_list;
-  if (input_dict->GetList("ids", &ids_list)) {
-    for (size_t i = 0; i < ids_list->GetSize(); i++) {
-      if (!ids_list->GetList()[i].is_string()) {
-        continue;
-      }
-      ids.push_back(ids_list->GetList()[i].GetString());
-    }
-  }
 
   ad_block_service_->GetTaskRunner()->PostTaskAndReplyWithResult(
       FROM_HERE,
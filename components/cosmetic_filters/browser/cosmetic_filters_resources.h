@@ -43,7 +43,8 @@ class CosmeticFiltersResources final
 
   // Sends back to renderer a response about rules that has to be applied
   // for the specified selectors.
-  void HiddenClassIdSelectors(const std::string& input,
+  void HiddenClassIdSelectors(const std::vector<std::string>& classes,
+                              const std::vector<std::string>& ids,
                               const std::vector<std::string>& exceptions,
                               HiddenClassIdSelectorsCallback callback) override;
 
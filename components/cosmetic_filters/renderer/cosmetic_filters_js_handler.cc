@@ -6,6 +6,7 @@
 #include "brave/components/cosmetic_filters/renderer/cosmetic_filters_js_handler.h"
 
 #include "base/bind.h"
+#include "base/json/json_reader.h"
 #include "base/json/json_writer.h"
 #include "base/no_destructor.h"
 #include "base/strings/stringprintf.h"
@@ -28,6 +29,30 @@ static base::NoDestructor<std::string> g_observing_script("");
 static base::NoDestructor<std::vector<std::string>> g_vetted_search_engines(
     {"duckduckgo", "qwant", "bing", "startpage", "google", "yandex", "ecosia"});
 
+// Mutation heavy pages report classes and ids in many small bursts, they are
+// coalesced into a single request over this interval.
+constexpr base::TimeDelta kHiddenClassIdSelectorsDelay =
+    base::TimeDelta::FromMilliseconds(50);
+
+// Long lived single page apps keep generating new classes and ids, the set of
+// already queried ones is dropped once it gets this large. Querying a class or
+// id again is harmless, it only costs a redundant lookup.
+constexpr size_t kMaxQueriedSelectors = 10000;
+
+// Appends the strings of |list| which aren't in |queried| to |pending|.
+void QueueNotQueried(const base::Value* list,
+                     std::unordered_set<std::string>* queried,
+                     std::vector<std::string>* pending) {
+  if (!list)
+    return;
+  if (queried->size() > kMaxQueriedSelectors)
+    queried->clear();
+  for (const auto& item : list->GetList()) {
+    if (item.is_string() && queried->insert(item.GetString()).second)
+      pending->push_back(item.GetString());
+  }
+}
+
 const char kPreInitScript[] =
     R"((function() {
           if (window.content_cosmetic == undefined) {
@@ -145,13 +170,35 @@ CosmeticFiltersJSHandler::~CosmeticFiltersJSHandler() = default;
 
 void CosmeticFiltersJSHandler::HiddenClassIdSelectors(
     const std::string& input) {
+  base::Optional<base::Value> input_value = base::JSONReader::Read(input);
+  if (!input_value || !input_value->is_dict())
+    return;
+
+  QueueNotQueried(input_value->FindListKey("classes"), &queried_classes_,
+                  &pending_classes_);
+  QueueNotQueried(input_value->FindListKey("ids"), &queried_ids_,
+                  &pending_ids_);
+  if (pending_classes_.empty() && pending_ids_.empty())
+    return;
+
+  if (!hidden_class_id_selectors_timer_.IsRunning()) {
+    hidden_class_id_selectors_timer_.Start(
+        FROM_HERE, kHiddenClassIdSelectorsDelay,
+        base::BindOnce(&CosmeticFiltersJSHandler::FlushHiddenClassIdSelectors,
+                       base::Unretained(this)));
+  }
+}
+
+void CosmeticFiltersJSHandler::FlushHiddenClassIdSelectors() {
   if (!EnsureConnected())
     return;
 
   cosmetic_filters_resources_->HiddenClassIdSelectors(
-      input, exceptions_,
+      std::move(pending_classes_), std::move(pending_ids_), exceptions_,
       base::BindOnce(&CosmeticFiltersJSHandler::OnHiddenClassIdSelectors,
                      base::Unretained(this)));
+  pending_classes_.clear();
+  pending_ids_.clear();
 }
 
 void CosmeticFiltersJSHandler::AddJavaScriptObjectToFrame(
@@ -219,6 +266,14 @@ bool CosmeticFiltersJSHandler::EnsureConnected() {
 }
 
 void CosmeticFiltersJSHandler::ProcessURL(const GURL& url) {
+  // Start from a clean state for the new document. The connection to the
+  // browser is kept, it holds no per document state.
+  hidden_class_id_selectors_timer_.Stop();
+  queried_classes_.clear();
+  queried_ids_.clear();
+  pending_classes_.clear();
+  pending_ids_.clear();
+  exceptions_.clear();
   if (!EnsureConnected())
     return;
 
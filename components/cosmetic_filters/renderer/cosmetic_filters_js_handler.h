@@ -7,8 +7,10 @@
 #define BRAVE_COMPONENTS_COSMETIC_FILTERS_RENDERER_COSMETIC_FILTERS_JS_HANDLER_H_
 
 #include <string>
+#include <unordered_set>
 #include <vector>
 
+#include "base/timer/timer.h"
 #include "brave/components/cosmetic_filters/common/cosmetic_filters.mojom.h"
 #include "content/public/renderer/render_frame.h"
 #include "content/public/renderer/render_frame_observer.h"
@@ -47,8 +49,11 @@ class CosmeticFiltersJSHandler {
 
   void CreateWorkerObject(v8::Isolate* isolate, v8::Local<v8::Context> context);
 
-  // A function to be called from JS
+  // A function to be called from JS. Queues the classes and ids which
+  // weren't queried for the current document yet.
   void HiddenClassIdSelectors(const std::string& input);
+  // Sends the queued classes and ids to the browser in one request.
+  void FlushHiddenClassIdSelectors();
 
   void OnShouldDoCosmeticFiltering(bool enabled, bool first_party_enabled);
   void OnUrlCosmeticResources(base::Value result);
@@ -62,6 +67,13 @@ class CosmeticFiltersJSHandler {
   bool enabled_1st_party_cf_;
   std::vector<std::string> exceptions_;
   GURL url_;
+  // Classes and ids already queried for the current document, and those
+  // waiting to be sent.
+  std::unordered_set<std::string> queried_classes_;
+  std::unordered_set<std::string> queried_ids_;
+  std::vector<std::string> pending_classes_;
+  std::vector<std::string> pending_ids_;
+  base::OneShotTimer hidden_class_id_selectors_timer_;
 };
 
 // static
@@ -5,115 +5,122 @@
 
 #include "brave/components/p3a/brave_histogram_rewrite.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/metrics/statistics_recorder.h"
+#include "base/stl_util.h"
 
 namespace brave {
 
 namespace {
 
-// Please keep this list sorted and synced with |DoHistogramBravezation|.
-constexpr const char* kBravezationHistograms[] = {
-    "Bookmarks.Count.OnProfileLoad",
-    "DefaultBrowser.State",
-    "Extensions.LoadExtension",
-    "Tabs.TabCount",
-    "Tabs.TabCountPerLoad",
-    "Tabs.WindowCount",
-};
+void RecordBookmarksCount(base::HistogramBase::Sample sample) {
+  constexpr int kIntervals[] = {5, 20, 100, 500, 1000, 5000, 10000};
+  const int* it = std::lower_bound(kIntervals, std::end(kIntervals), sample);
+  const int answer = it - kIntervals;
+  UMA_HISTOGRAM_EXACT_LINEAR("Brave.Core.BookmarksCountOnProfileLoad.2",
+                             answer, base::size(kIntervals));
+}
 
-// TODO(iefremov): Replace a bunch of 'if's with something more elegant.
-// Records the given sample using the proper Brave way.
-void DoHistogramBravezation(const char* histogram_name,
-                            uint64_t name_hash,
-                            base::HistogramBase::Sample sample) {
-  DCHECK(histogram_name);
-  if (strcmp("Bookmarks.Count.OnProfileLoad", histogram_name) == 0) {
-    constexpr int kIntervals[] = {5, 20, 100, 500, 1000, 5000, 10000};
-    const int* it =
-        std::lower_bound(kIntervals, std::end(kIntervals), sample);
-    const int answer = it - kIntervals;
-    UMA_HISTOGRAM_EXACT_LINEAR("Brave.Core.BookmarksCountOnProfileLoad.2",
-                               answer, base::size(kIntervals));
-    return;
+void RecordDefaultBrowserState(base::HistogramBase::Sample sample) {
+  int answer = 0;
+  switch (sample) {
+    case 0:  // Not default.
+    case 1:  // Default.
+      answer = sample;
+      break;
+    case 2:  // Unknown, merging to "Not default".
+      answer = 0;
+      break;
+    case 3:  // Other mode is default, merging to "Default".
+      answer = 1;
+      break;
+  default:
+    NOTREACHED();
   }
+  UMA_HISTOGRAM_BOOLEAN("Brave.Core.IsDefault", answer);
+}
 
-  if (strcmp("DefaultBrowser.State", histogram_name) == 0) {
-    int answer = 0;
-    switch (sample) {
-      case 0:  // Not default.
-      case 1:  // Default.
-        answer = sample;
-        break;
-      case 2:  // Unknown, merging to "Not default".
-        answer = 0;
-        break;
-      case 3:  // Other mode is default, merging to "Default".
-        answer = 1;
-        break;
-    default:
-      NOTREACHED();
-    }
-    UMA_HISTOGRAM_BOOLEAN("Brave.Core.IsDefault", answer);
-  }
+void RecordNumberOfExtensions(base::HistogramBase::Sample sample) {
+  int answer = 0;
+  if (sample == 1)
+    answer = 1;
+  else if (2 <= sample && sample <= 4)
+    answer = 2;
+  else if (sample >= 5)
+    answer = 3;
 
-  if (strcmp("Extensions.LoadExtension", histogram_name) == 0) {
-    int answer = 0;
-    if (sample == 1)
-      answer = 1;
-    else if (2 <= sample && sample <= 4)
-      answer = 2;
-    else if (sample >= 5)
-      answer = 3;
+  UMA_HISTOGRAM_EXACT_LINEAR("Brave.Core.NumberOfExtensions", answer, 3);
+}
 
-    UMA_HISTOGRAM_EXACT_LINEAR("Brave.Core.NumberOfExtensions", answer, 3);
-    return;
+void RecordTabCount(base::HistogramBase::Sample sample) {
+  int answer = 0;
+  if (0 <= sample && sample <= 1) {
+    answer = 0;
+  } else if (2 <= sample && sample <= 5) {
+    answer = 1;
+  } else if (6 <= sample && sample <= 10) {
+    answer = 2;
+  } else if (11 <= sample && sample <= 50) {
+    answer = 3;
+  } else {
+    answer = 4;
   }
 
-  if (strcmp("Tabs.TabCount", histogram_name) == 0 ||
-      strcmp("Tabs.TabCountPerLoad", histogram_name) == 0) {
-    int answer = 0;
-    if (0 <= sample && sample <= 1) {
-      answer = 0;
-    } else if (2 <= sample && sample <= 5) {
-      answer = 1;
-    } else if (6 <= sample && sample <= 10) {
-      answer = 2;
-    } else if (11 <= sample && sample <= 50) {
-      answer = 3;
-    } else {
-      answer = 4;
-    }
-
-    UMA_HISTOGRAM_EXACT_LINEAR("Brave.Core.TabCount", answer, 4);
-    return;
-  }
+  UMA_HISTOGRAM_EXACT_LINEAR("Brave.Core.TabCount", answer, 4);
+}
 
-  if (strcmp("Tabs.WindowCount", histogram_name) == 0) {
-    int answer = 0;
-    if (sample <= 0) {
-      answer = 0;
-    } else if (sample == 1) {
-      answer = 1;
-    } else if (2 <= sample && sample <= 5) {
-      answer = 2;
-    } else {
-      answer = 3;
-    }
-
-    UMA_HISTOGRAM_EXACT_LINEAR("Brave.Core.WindowCount.2", answer, 3);
-    return;
+void RecordWindowCount(base::HistogramBase::Sample sample) {
+  int answer = 0;
+  if (sample <= 0) {
+    answer = 0;
+  } else if (sample == 1) {
+    answer = 1;
+  } else if (2 <= sample && sample <= 5) {
+    answer = 2;
+  } else {
+    answer = 3;
   }
+
+  UMA_HISTOGRAM_EXACT_LINEAR("Brave.Core.WindowCount.2", answer, 3);
+}
+
+using BravezationFunction = void (*)(base::HistogramBase::Sample);
+
+struct BravezationHistogram {
+  const char* name;
+  // Records the given sample using the proper Brave way.
+  BravezationFunction record;
+};
+
+// Please keep this list sorted. Each handler is bound to the callback of its
+// histogram, so no name matching is done per sample.
+constexpr BravezationHistogram kBravezationHistograms[] = {
+    {"Bookmarks.Count.OnProfileLoad", &RecordBookmarksCount},
+    {"DefaultBrowser.State", &RecordDefaultBrowserState},
+    {"Extensions.LoadExtension", &RecordNumberOfExtensions},
+    {"Tabs.TabCount", &RecordTabCount},
+    {"Tabs.TabCountPerLoad", &RecordTabCount},
+    {"Tabs.WindowCount", &RecordWindowCount},
+};
+
+// Adapts a |BravezationFunction| to the histogram callback signature.
+void RunBravezationFunction(BravezationFunction record,
+                            const char* /* histogram_name */,
+                            uint64_t /* name_hash */,
+                            base::HistogramBase::Sample sample) {
+  record(sample);
 }
 
 }  // namespace
 
 void SetupHistogramsBraveization() {
-  for (const char* histogram_name : kBravezationHistograms) {
+  for (const auto& histogram : kBravezationHistograms) {
     base::StatisticsRecorder::SetCallback(
-        histogram_name,
-        base::BindRepeating(&DoHistogramBravezation));
+        histogram.name,
+        base::BindRepeating(&RunBravezationFunction, histogram.record));
   }
 }
 
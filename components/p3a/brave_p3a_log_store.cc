@@ -5,11 +5,14 @@
 
 #include "brave/components/p3a/brave_p3a_log_store.h"
 
+#include <utility>
+
 #include "base/logging.h"
 #include "base/metrics/histogram_macros.h"
 #include "base/rand_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/strings/string_util.h"
+#include "base/values.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/pref_service.h"
 #include "components/prefs/scoped_user_pref_update.h"
@@ -57,22 +60,14 @@ void BraveP3ALogStore::UpdateValue(const std::string& histogram_name,
     DCHECK(entry.sent_timestamp.is_null());
     unsent_entries_.insert(histogram_name);
   }
-
-  // Update the persistent value.
-  DictionaryPrefUpdate update(local_state_, kPrefName);
-  update->SetPath({histogram_name, kLogValueKey},
-                  base::Value(base::NumberToString(value)));
-  update->SetPath({histogram_name, kLogSentKey}, base::Value(entry.sent));
+  has_unpersisted_changes_ = true;
 }
 
 void BraveP3ALogStore::RemoveValueIfExists(const std::string& histogram_name) {
   DCHECK(delegate_->IsActualMetric(histogram_name));
   log_.erase(histogram_name);
   unsent_entries_.erase(histogram_name);
-
-  // Update the persistent value.
-  DictionaryPrefUpdate update(local_state_, kPrefName);
-  update->RemovePath(histogram_name);
+  has_unpersisted_changes_ = true;
 
   if (has_staged_log() && staged_entry_key_ == histogram_name) {
     staged_entry_key_.clear();
@@ -82,18 +77,13 @@ void BraveP3ALogStore::RemoveValueIfExists(const std::string& histogram_name) {
 
 void BraveP3ALogStore::ResetUploadStamps() {
   // Clear log entries flags.
-  DictionaryPrefUpdate update(local_state_, kPrefName);
   for (auto& pair : log_) {
     if (pair.second.sent) {
       DCHECK(!pair.second.sent_timestamp.is_null());
       DCHECK(!unsent_entries_.contains(pair.first));
 
       pair.second.ResetSentState();
-
-      // Update persistent values.
-      update->SetPath({pair.first, kLogSentKey}, base::Value(pair.second.sent));
-      update->SetPath({pair.first, kLogTimestampKey},
-                      base::Value(pair.second.sent_timestamp.ToDoubleT()));
+      has_unpersisted_changes_ = true;
     }
   }
 
@@ -166,13 +156,7 @@ void BraveP3ALogStore::DiscardStagedLog() {
   auto log_iter = log_.find(staged_entry_key_);
   DCHECK(log_iter != log_.end());
   log_iter->second.MarkAsSent();
-
-  // Update the persistent value.
-  DictionaryPrefUpdate update(local_state_, kPrefName);
-  update->SetPath({log_iter->first, kLogSentKey},
-                  base::Value(log_iter->second.sent));
-  update->SetPath({log_iter->first, kLogTimestampKey},
-                  base::Value(log_iter->second.sent_timestamp.ToDoubleT()));
+  has_unpersisted_changes_ = true;
 
   // Erase the entry from the unsent queue.
   auto unsent_entries_iter = unsent_entries_.find(staged_entry_key_);
@@ -186,7 +170,22 @@ void BraveP3ALogStore::DiscardStagedLog() {
 void BraveP3ALogStore::MarkStagedLogAsSent() {}
 
 void BraveP3ALogStore::TrimAndPersistUnsentLogs() {
-  NOTREACHED();
+  if (!has_unpersisted_changes_) {
+    return;
+  }
+
+  base::Value logs(base::Value::Type::DICTIONARY);
+  for (const auto& pair : log_) {
+    base::Value entry(base::Value::Type::DICTIONARY);
+    entry.SetStringKey(kLogValueKey, base::NumberToString(pair.second.value));
+    entry.SetBoolKey(kLogSentKey, pair.second.sent);
+    entry.SetDoubleKey(kLogTimestampKey,
+                       pair.second.sent_timestamp.ToDoubleT());
+    logs.SetKey(pair.first, std::move(entry));
+  }
+
+  local_state_->Set(kPrefName, logs);
+  has_unpersisted_changes_ = false;
 }
 
 void BraveP3ALogStore::LoadPersistedUnsentLogs() {
@@ -209,10 +208,10 @@ void BraveP3ALogStore::LoadPersistedUnsentLogs() {
     if (const base::Value* v =
             dict.FindKeyOfType(kLogValueKey, base::Value::Type::STRING)) {
       if (!base::StringToUint64(v->GetString(), &entry.value)) {
-        return;
+        continue;
       }
     } else {
-      return;
+      continue;
     }
 
     // Sent flag.
@@ -220,7 +219,7 @@ void BraveP3ALogStore::LoadPersistedUnsentLogs() {
             dict.FindKeyOfType(kLogSentKey, base::Value::Type::BOOLEAN)) {
       entry.sent = v->GetBool();
     } else {
-      return;
+      continue;
     }
 
     // Timestamp.
@@ -229,7 +228,7 @@ void BraveP3ALogStore::LoadPersistedUnsentLogs() {
       entry.sent_timestamp = base::Time::FromDoubleT(v->GetDouble());
       if ((entry.sent && entry.sent_timestamp.is_null()) ||
           (!entry.sent && !entry.sent_timestamp.is_null())) {
-        return;
+        continue;
       }
     } else {
       // Sometimes we do not persist empty timestamps, so it is ok.
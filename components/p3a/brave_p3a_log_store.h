@@ -19,9 +19,10 @@ class PrefRegistrySimple;
 
 namespace brave {
 
-// Stores all given values in memory and persists in prefs on the fly.
-// All logs (not only unsent are persistent), and all logs could be loaded
-// using |LoadPersistedUnsentLogs()|. We should fix this at some point since
+// Stores all given values in memory and persists them in prefs on
+// |TrimAndPersistUnsentLogs()|, so that a batch of changes results in a single
+// pref write. All logs (not only unsent are persistent), and all logs could be
+// loaded using |LoadPersistedUnsentLogs()|. We should fix this at some point since
 // for now persisted entries never expire.
 class BraveP3ALogStore : public metrics::LogStore {
  public:
@@ -60,10 +61,10 @@ class BraveP3ALogStore : public metrics::LogStore {
   void DiscardStagedLog() override;
   void MarkStagedLogAsSent() override;
 
-  // |TrimAndPersistUnsentLogs| should not be used, since we persist everything
-  // on the fly.
+  // Writes the whole log to prefs if it has changed since the last call.
+  // Nothing is trimmed, since the log holds one entry per metric.
   void TrimAndPersistUnsentLogs() override;
-  // Returns early if founds malformed persisted values.
+  // Skips malformed persisted values.
   void LoadPersistedUnsentLogs() override;
 
  private:
@@ -91,6 +92,9 @@ class BraveP3ALogStore : public metrics::LogStore {
   base::flat_map<std::string, LogEntry> log_;
   base::flat_set<std::string> unsent_entries_;
 
+  // Whether |log_| has changes that are not persisted yet.
+  bool has_unpersisted_changes_ = false;
+
   std::string staged_entry_key_;
   std::string staged_log_;
 
@@ -0,0 +1,164 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_log_store.h"
+
+#include <memory>
+#include <string>
+#include <utility>
+
+#include "base/bind.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/values.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "components/prefs/testing_pref_service.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BraveP3ALogStoreTest.*
+
+namespace brave {
+
+namespace {
+
+constexpr char kPrefName[] = "p3a.logs";
+
+class TestDelegate : public BraveP3ALogStore::Delegate {
+ public:
+  std::string Serialize(base::StringPiece histogram_name,
+                        uint64_t value) override {
+    return histogram_name.as_string() + ":" + base::NumberToString(value);
+  }
+
+  bool IsActualMetric(base::StringPiece histogram_name) const override {
+    return true;
+  }
+};
+
+}  // namespace
+
+class BraveP3ALogStoreTest : public testing::Test {
+ protected:
+  void SetUp() override {
+    BraveP3ALogStore::RegisterPrefs(local_state_.registry());
+    pref_change_registrar_.Init(&local_state_);
+    pref_change_registrar_.Add(
+        kPrefName,
+        base::BindRepeating(&BraveP3ALogStoreTest::OnLogsPrefChanged,
+                            base::Unretained(this)));
+  }
+
+  std::unique_ptr<BraveP3ALogStore> CreateLogStore() {
+    auto log_store =
+        std::make_unique<BraveP3ALogStore>(&delegate_, &local_state_);
+    log_store->LoadPersistedUnsentLogs();
+    // Loading reports the pref as changed even when nothing was dropped.
+    pref_writes_count_ = 0;
+    return log_store;
+  }
+
+  const base::Value* GetPersistedEntry(const std::string& histogram_name) {
+    return local_state_.GetDictionary(kPrefName)->FindDictKey(histogram_name);
+  }
+
+  void OnLogsPrefChanged() { pref_writes_count_++; }
+
+  TestingPrefServiceSimple local_state_;
+  TestDelegate delegate_;
+  PrefChangeRegistrar pref_change_registrar_;
+  size_t pref_writes_count_ = 0;
+};
+
+TEST_F(BraveP3ALogStoreTest, PersistsOncePerTrim) {
+  auto log_store = CreateLogStore();
+
+  log_store->UpdateValue("Brave.Test.First", 1);
+  log_store->UpdateValue("Brave.Test.First", 2);
+  log_store->UpdateValue("Brave.Test.Second", 3);
+  EXPECT_EQ(pref_writes_count_, 0u);
+
+  log_store->TrimAndPersistUnsentLogs();
+  EXPECT_EQ(pref_writes_count_, 1u);
+
+  const base::Value* entry = GetPersistedEntry("Brave.Test.First");
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(*entry->FindStringKey("value"), "2");
+  ASSERT_TRUE(GetPersistedEntry("Brave.Test.Second"));
+}
+
+TEST_F(BraveP3ALogStoreTest, TrimWithoutChangesIsNoop) {
+  auto log_store = CreateLogStore();
+
+  log_store->UpdateValue("Brave.Test.First", 1);
+  log_store->TrimAndPersistUnsentLogs();
+  EXPECT_EQ(pref_writes_count_, 1u);
+
+  // Would be overwritten if the log store persisted again.
+  local_state_.ClearPref(kPrefName);
+  EXPECT_EQ(pref_writes_count_, 2u);
+
+  log_store->TrimAndPersistUnsentLogs();
+  EXPECT_EQ(pref_writes_count_, 2u);
+  EXPECT_FALSE(GetPersistedEntry("Brave.Test.First"));
+}
+
+TEST_F(BraveP3ALogStoreTest, SentStateSurvivesReload) {
+  auto log_store = CreateLogStore();
+
+  log_store->UpdateValue("Brave.Test.Sent", 1);
+  log_store->TrimAndPersistUnsentLogs();
+  log_store->StageNextLog();
+  EXPECT_EQ(log_store->staged_log(), "Brave.Test.Sent:1");
+  log_store->DiscardStagedLog();
+  log_store->UpdateValue("Brave.Test.Unsent", 2);
+  log_store->TrimAndPersistUnsentLogs();
+
+  const base::Optional<double> sent_timestamp =
+      GetPersistedEntry("Brave.Test.Sent")->FindDoubleKey("timestamp");
+  ASSERT_TRUE(sent_timestamp);
+  EXPECT_NE(*sent_timestamp, 0.0);
+
+  log_store = CreateLogStore();
+
+  // Only the unsent entry is left to upload.
+  ASSERT_TRUE(log_store->has_unsent_logs());
+  log_store->StageNextLog();
+  EXPECT_EQ(log_store->staged_log(), "Brave.Test.Unsent:2");
+  log_store->DiscardStagedLog();
+  EXPECT_FALSE(log_store->has_unsent_logs());
+
+  // Persisting the reloaded log keeps the sent state of the first entry.
+  log_store->TrimAndPersistUnsentLogs();
+  const base::Value* entry = GetPersistedEntry("Brave.Test.Sent");
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(entry->FindBoolKey("sent"), true);
+  ASSERT_TRUE(entry->FindDoubleKey("timestamp"));
+  EXPECT_NEAR(*entry->FindDoubleKey("timestamp"), *sent_timestamp, 0.001);
+}
+
+TEST_F(BraveP3ALogStoreTest, LoadSkipsMalformedEntries) {
+  base::Value logs(base::Value::Type::DICTIONARY);
+  base::Value malformed(base::Value::Type::DICTIONARY);
+  malformed.SetStringKey("value", "not a number");
+  malformed.SetBoolKey("sent", false);
+  logs.SetKey("Brave.Test.Malformed", std::move(malformed));
+  base::Value valid(base::Value::Type::DICTIONARY);
+  valid.SetStringKey("value", "3");
+  valid.SetBoolKey("sent", false);
+  logs.SetKey("Brave.Test.Valid", std::move(valid));
+  local_state_.Set(kPrefName, logs);
+
+  auto log_store = CreateLogStore();
+
+  ASSERT_TRUE(log_store->has_unsent_logs());
+  log_store->StageNextLog();
+  EXPECT_EQ(log_store->staged_log(), "Brave.Test.Valid:3");
+  log_store->DiscardStagedLog();
+  EXPECT_FALSE(log_store->has_unsent_logs());
+
+  log_store->TrimAndPersistUnsentLogs();
+  EXPECT_TRUE(GetPersistedEntry("Brave.Test.Valid"));
+}
+
+}  // namespace brave
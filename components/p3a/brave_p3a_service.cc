@@ -5,6 +5,7 @@
 
 #include "brave/components/p3a/brave_p3a_service.h"
 
+#include <limits>
 #include <memory>
 #include <string>
 
@@ -15,8 +16,8 @@
 #include "base/metrics/metrics_hashes.h"
 #include "base/metrics/sample_vector.h"
 #include "base/metrics/statistics_recorder.h"
-#include "base/no_destructor.h"
 #include "base/rand_util.h"
+#include "base/stl_util.h"
 #include "base/strings/string_number_conversions.h"
 #include "base/task/post_task.h"
 #include "base/trace_event/trace_event.h"
@@ -31,11 +32,13 @@
 #include "brave/components/p3a/brave_p3a_scheduler.h"
 #include "brave/components/p3a/brave_p3a_switches.h"
 #include "brave/components/p3a/brave_p3a_uploader.h"
+#include "brave/components/p3a/metric_names.h"
 #include "brave/components/p3a/pref_names.h"
 #include "brave/vendor/brave_base/random.h"
 #include "components/prefs/pref_registry_simple.h"
 #include "components/prefs/pref_service.h"
 #include "content/public/browser/browser_task_traits.h"
+#include "content/public/browser/browser_thread.h"
 #include "services/network/public/cpp/shared_url_loader_factory.h"
 #include "third_party/metrics_proto/reporting_info.pb.h"
 
@@ -56,113 +59,62 @@ constexpr char kP2AServerUrl[] = "https://p2a.brave.com/";
 
 constexpr uint64_t kDefaultUploadIntervalSeconds = 60;  // 1 minute.
 
-// TODO(iefremov): Provide moar histograms!
-// Whitelist for histograms that we collect. Will be replaced with something
-// updating on the fly.
-constexpr const char* kCollectedHistograms[] = {
-    "Brave.Core.BookmarksCountOnProfileLoad.2",
-    "Brave.Core.CrashReportsEnabled",
-    "Brave.Core.IsDefault",
-    "Brave.Core.LastTimeIncognitoUsed",
-    "Brave.Core.NumberOfExtensions",
-    "Brave.Core.TabCount",
-    "Brave.Core.TorEverUsed",
-    "Brave.Core.WindowCount.2",
-    "Brave.Importer.ImporterSource",
-    "Brave.NTP.CustomizeUsageStatus",
-    "Brave.NTP.NewTabsCreated",
-    "Brave.NTP.SponsoredImagesEnabled",
-    "Brave.NTP.SponsoredNewTabsCreated",
-    "Brave.Omnibox.SearchCount",
-    "Brave.P3A.SentAnswersCount",
-    "Brave.Rewards.AdsState.2",
-    "Brave.Rewards.AutoContributionsState.2",
-    "Brave.Rewards.TipsState.2",
-    "Brave.Rewards.WalletBalance.2",
-    "Brave.Savings.BandwidthSavingsMB",
-    "Brave.Search.DefaultEngine.4",
-    "Brave.Shields.UsageStatus",
-    "Brave.SpeedReader.Enabled",
-    "Brave.SpeedReader.ToggleCount",
-    "Brave.Today.HasEverInteracted",
-    "Brave.Today.WeeklySessionCount",
-    "Brave.Today.WeeklyMaxCardViewsCount",
-    "Brave.Today.WeeklyMaxCardVisitsCount",
-    "Brave.Sync.Status",
-    "Brave.Uptime.BrowserOpenMinutes",
-    "Brave.Welcome.InteractionStatus",
-
-    // IPFS
-    "Brave.IPFS.IPFSCompanionInstalled",
-    "Brave.IPFS.DetectionPromptCount",
-    "Brave.IPFS.GatewaySetting",
-    "Brave.IPFS.DaemonRunTime",
-
-    // P2A
-    // Ad Opportunities
-    "Brave.P2A.TotalAdOpportunities",
-    "Brave.P2A.AdOpportunitiesPerSegment.architecture",
-    "Brave.P2A.AdOpportunitiesPerSegment.artsentertainment",
-    "Brave.P2A.AdOpportunitiesPerSegment.automotive",
-    "Brave.P2A.AdOpportunitiesPerSegment.business",
-    "Brave.P2A.AdOpportunitiesPerSegment.careers",
-    "Brave.P2A.AdOpportunitiesPerSegment.cellphones",
-    "Brave.P2A.AdOpportunitiesPerSegment.crypto",
-    "Brave.P2A.AdOpportunitiesPerSegment.education",
-    "Brave.P2A.AdOpportunitiesPerSegment.familyparenting",
-    "Brave.P2A.AdOpportunitiesPerSegment.fashion",
-    "Brave.P2A.AdOpportunitiesPerSegment.folklore",
-    "Brave.P2A.AdOpportunitiesPerSegment.fooddrink",
-    "Brave.P2A.AdOpportunitiesPerSegment.gaming",
-    "Brave.P2A.AdOpportunitiesPerSegment.healthfitness",
-    "Brave.P2A.AdOpportunitiesPerSegment.history",
-    "Brave.P2A.AdOpportunitiesPerSegment.hobbiesinterests",
-    "Brave.P2A.AdOpportunitiesPerSegment.home",
-    "Brave.P2A.AdOpportunitiesPerSegment.law",
-    "Brave.P2A.AdOpportunitiesPerSegment.military",
-    "Brave.P2A.AdOpportunitiesPerSegment.other",
-    "Brave.P2A.AdOpportunitiesPerSegment.personalfinance",
-    "Brave.P2A.AdOpportunitiesPerSegment.pets",
-    "Brave.P2A.AdOpportunitiesPerSegment.realestate",
-    "Brave.P2A.AdOpportunitiesPerSegment.science",
-    "Brave.P2A.AdOpportunitiesPerSegment.sports",
-    "Brave.P2A.AdOpportunitiesPerSegment.technologycomputing",
-    "Brave.P2A.AdOpportunitiesPerSegment.travel",
-    "Brave.P2A.AdOpportunitiesPerSegment.weather",
-    "Brave.P2A.AdOpportunitiesPerSegment.untargeted",
-    // Ad Impressions
-    "Brave.P2A.TotalAdImpressions",
-    "Brave.P2A.AdImpressionsPerSegment.architecture",
-    "Brave.P2A.AdImpressionsPerSegment.artsentertainment",
-    "Brave.P2A.AdImpressionsPerSegment.automotive",
-    "Brave.P2A.AdImpressionsPerSegment.business",
-    "Brave.P2A.AdImpressionsPerSegment.careers",
-    "Brave.P2A.AdImpressionsPerSegment.cellphones",
-    "Brave.P2A.AdImpressionsPerSegment.crypto",
-    "Brave.P2A.AdImpressionsPerSegment.education",
-    "Brave.P2A.AdImpressionsPerSegment.familyparenting",
-    "Brave.P2A.AdImpressionsPerSegment.fashion",
-    "Brave.P2A.AdImpressionsPerSegment.folklore",
-    "Brave.P2A.AdImpressionsPerSegment.fooddrink",
-    "Brave.P2A.AdImpressionsPerSegment.gaming",
-    "Brave.P2A.AdImpressionsPerSegment.healthfitness",
-    "Brave.P2A.AdImpressionsPerSegment.history",
-    "Brave.P2A.AdImpressionsPerSegment.hobbiesinterests",
-    "Brave.P2A.AdImpressionsPerSegment.home",
-    "Brave.P2A.AdImpressionsPerSegment.law",
-    "Brave.P2A.AdImpressionsPerSegment.military",
-    "Brave.P2A.AdImpressionsPerSegment.other",
-    "Brave.P2A.AdImpressionsPerSegment.personalfinance",
-    "Brave.P2A.AdImpressionsPerSegment.pets",
-    "Brave.P2A.AdImpressionsPerSegment.realestate",
-    "Brave.P2A.AdImpressionsPerSegment.science",
-    "Brave.P2A.AdImpressionsPerSegment.sports",
-    "Brave.P2A.AdImpressionsPerSegment.technologycomputing",
-    "Brave.P2A.AdImpressionsPerSegment.travel",
-    "Brave.P2A.AdImpressionsPerSegment.weather",
-    "Brave.P2A.AdImpressionsPerSegment.untargeted"
+// Histogram samples are coalesced for this long before updating the log.
+constexpr int64_t kSampleFlushDelaySeconds = 5;
+
+// Marks a histogram without a pending bucket, see |pending_buckets_|.
+constexpr uint64_t kNoPendingBucket = std::numeric_limits<uint64_t>::max();
+
+// Open addressing hash table of |kCollectedHistograms| built at compile time,
+// so that looking up a metric name costs a hash and usually a single string
+// comparison however many histograms are collected.
+constexpr size_t kCollectedHistogramsTableSize = 256;
+static_assert((kCollectedHistogramsTableSize &
+               (kCollectedHistogramsTableSize - 1)) == 0,
+              "Table size must be a power of two");
+static_assert(kCollectedHistogramsTableSize >=
+                  2 * base::size(kCollectedHistograms),
+              "Table must stay at most half full to keep probing short");
+
+struct CollectedHistogramsTable {
+  // Index into |kCollectedHistograms| plus one, zero for empty slots.
+  uint16_t slots[kCollectedHistogramsTableSize];
 };
 
+// 32-bit FNV-1a.
+constexpr uint32_t HashHistogramName(const char* name, size_t length) {
+  uint32_t hash = 2166136261u;
+  for (size_t i = 0; i < length; i++) {
+    hash = (hash ^ static_cast<uint8_t>(name[i])) * 16777619u;
+  }
+  return hash;
+}
+
+constexpr size_t GetHistogramNameLength(const char* name) {
+  size_t length = 0;
+  while (name[length] != '\0') {
+    length++;
+  }
+  return length;
+}
+
+constexpr CollectedHistogramsTable BuildCollectedHistogramsTable() {
+  CollectedHistogramsTable table = {};
+  for (size_t i = 0; i < base::size(kCollectedHistograms); i++) {
+    const char* name = kCollectedHistograms[i];
+    size_t slot = HashHistogramName(name, GetHistogramNameLength(name)) &
+                  (kCollectedHistogramsTableSize - 1);
+    while (table.slots[slot] != 0) {
+      slot = (slot + 1) & (kCollectedHistogramsTableSize - 1);
+    }
+    table.slots[slot] = static_cast<uint16_t>(i + 1);
+  }
+  return table;
+}
+
+constexpr CollectedHistogramsTable kCollectedHistogramsTable =
+    BuildCollectedHistogramsTable();
+
 bool IsSuspendedMetric(base::StringPiece metric_name,
                        uint64_t value_or_bucket) {
   return value_or_bucket == kSuspendedMetricBucket;
@@ -194,7 +146,11 @@ base::TimeDelta TimeDeltaTillMonday(base::Time time) {
 }  // namespace
 
 BraveP3AService::BraveP3AService(PrefService* local_state)
-    : local_state_(local_state) {}
+    : local_state_(local_state) {
+  for (auto& pending_bucket : pending_buckets_) {
+    pending_bucket.store(kNoPendingBucket);
+  }
+}
 
 BraveP3AService::~BraveP3AService() = default;
 
@@ -209,10 +165,10 @@ void BraveP3AService::RegisterPrefs(PrefRegistrySimple* registry,
 }
 
 void BraveP3AService::InitCallbacks() {
-  for (const char* histogram_name : kCollectedHistograms) {
+  for (size_t i = 0; i < base::size(kCollectedHistograms); i++) {
     base::StatisticsRecorder::SetCallback(
-        histogram_name,
-        base::BindRepeating(&BraveP3AService::OnHistogramChanged, this));
+        kCollectedHistograms[i],
+        base::BindRepeating(&BraveP3AService::OnHistogramChanged, this, i));
   }
 }
 
@@ -257,6 +213,7 @@ void BraveP3AService::Init(
       DoRotation();
     }
   }
+  log_store_->TrimAndPersistUnsentLogs();
 
   // Init other components.
   uploader_.reset(new BraveP3AUploader(
@@ -277,6 +234,12 @@ void BraveP3AService::Init(
   }
 }
 
+void BraveP3AService::OnShutdown() {
+  DCHECK_CURRENTLY_ON(content::BrowserThread::UI);
+  // The delayed flush would not run anymore.
+  FlushPendingSamples();
+}
+
 std::string BraveP3AService::Serialize(base::StringPiece histogram_name,
                                        uint64_t value) {
   // TRACE_EVENT0("brave_p3a", "SerializeMessage");
@@ -300,10 +263,17 @@ std::string BraveP3AService::Serialize(base::StringPiece histogram_name,
 
 bool
 BraveP3AService::IsActualMetric(base::StringPiece histogram_name) const {
-  static const base::NoDestructor<base::flat_set<base::StringPiece>>
-      metric_names {std::begin(kCollectedHistograms),
-                    std::end(kCollectedHistograms)};
-  return metric_names->contains(histogram_name);
+  size_t slot =
+      HashHistogramName(histogram_name.data(), histogram_name.size()) &
+      (kCollectedHistogramsTableSize - 1);
+  for (; kCollectedHistogramsTable.slots[slot] != 0;
+       slot = (slot + 1) & (kCollectedHistogramsTableSize - 1)) {
+    if (histogram_name ==
+        kCollectedHistograms[kCollectedHistogramsTable.slots[slot] - 1]) {
+      return true;
+    }
+  }
+  return false;
 }
 
 void BraveP3AService::MaybeOverrideSettingsFromCommandLine() {
@@ -398,9 +368,11 @@ void BraveP3AService::StartScheduledUpload() {
   }
 }
 
-void BraveP3AService::OnHistogramChanged(const char* histogram_name,
+void BraveP3AService::OnHistogramChanged(size_t histogram_index,
+                                         const char* histogram_name,
                                          uint64_t name_hash,
                                          base::HistogramBase::Sample sample) {
+  DCHECK_LT(histogram_index, base::size(kCollectedHistograms));
   std::unique_ptr<base::HistogramSamples> samples =
       base::StatisticsRecorder::FindHistogram(histogram_name)->SnapshotDelta();
   DCHECK(!samples->Iterator()->Done());
@@ -408,12 +380,7 @@ void BraveP3AService::OnHistogramChanged(const char* histogram_name,
   // Shortcut for the special values, see |kSuspendedMetricValue|
   // description for details.
   if (IsSuspendedMetric(histogram_name, sample)) {
-    base::PostTask(FROM_HERE, {content::BrowserThread::UI},
-                   base::BindOnce(&BraveP3AService::OnHistogramChangedOnUI,
-                                  this,
-                                  histogram_name,
-                                  kSuspendedMetricValue,
-                                  kSuspendedMetricBucket));
+    StorePendingBucket(histogram_index, kSuspendedMetricBucket);
     return;
   }
 
@@ -442,21 +409,44 @@ void BraveP3AService::OnHistogramChanged(const char* histogram_name,
     bucket = DirectEncodingProtocol::Perturb(bucket_count, bucket);
   }
 
-  base::PostTask(FROM_HERE, {content::BrowserThread::UI},
-                 base::BindOnce(&BraveP3AService::OnHistogramChangedOnUI, this,
-                                histogram_name, sample, bucket));
-}
-
-void BraveP3AService::OnHistogramChangedOnUI(const char* histogram_name,
-                                             base::HistogramBase::Sample sample,
-                                             size_t bucket) {
   VLOG(2) << "BraveP3AService::OnHistogramChanged: histogram_name = "
           << histogram_name << " Sample = " << sample << " bucket = " << bucket;
-  if (!initialized_) {
-    // Will handle it later when ready.
-    histogram_values_[histogram_name] = bucket;
-  } else {
-    HandleHistogramChange(histogram_name, bucket);
+  StorePendingBucket(histogram_index, bucket);
+}
+
+void BraveP3AService::StorePendingBucket(size_t histogram_index,
+                                         uint64_t bucket) {
+  // Only the latest bucket matters, so samples arriving before the flush
+  // simply overwrite each other.
+  pending_buckets_[histogram_index].store(bucket);
+  if (!flush_scheduled_.exchange(true)) {
+    base::PostDelayedTask(
+        FROM_HERE, {content::BrowserThread::UI},
+        base::BindOnce(&BraveP3AService::FlushPendingSamples, this),
+        base::TimeDelta::FromSeconds(kSampleFlushDelaySeconds));
+  }
+}
+
+void BraveP3AService::FlushPendingSamples() {
+  // Reset the flag before draining, so that a bucket stored after its slot
+  // has been drained schedules another flush.
+  flush_scheduled_.store(false);
+
+  for (size_t i = 0; i < base::size(kCollectedHistograms); i++) {
+    const uint64_t bucket = pending_buckets_[i].exchange(kNoPendingBucket);
+    if (bucket == kNoPendingBucket) {
+      continue;
+    }
+    if (!initialized_) {
+      // Will handle it later when ready.
+      histogram_values_[kCollectedHistograms[i]] = bucket;
+    } else {
+      HandleHistogramChange(kCollectedHistograms[i], bucket);
+    }
+  }
+
+  if (initialized_) {
+    log_store_->TrimAndPersistUnsentLogs();
   }
 }
 
@@ -482,6 +472,7 @@ void BraveP3AService::OnLogUploadComplete(int response_code,
           << " HTTP response = " << response_code;
   if (ok) {
     log_store_->DiscardStagedLog();
+    log_store_->TrimAndPersistUnsentLogs();
   }
   upload_scheduler_->UploadFinished(ok);
 }
@@ -489,6 +480,7 @@ void BraveP3AService::OnLogUploadComplete(int response_code,
 void BraveP3AService::DoRotation() {
   VLOG(2) << "BraveP3AService doing rotation at " << base::Time::Now();
   log_store_->ResetUploadStamps();
+  log_store_->TrimAndPersistUnsentLogs();
   UpdateRotationTimer();
 
   local_state_->SetTime(kLastRotationTimeStampPref, base::Time::Now());
@@ -6,15 +6,19 @@
 #ifndef BRAVE_COMPONENTS_P3A_BRAVE_P3A_SERVICE_H_
 #define BRAVE_COMPONENTS_P3A_BRAVE_P3A_SERVICE_H_
 
+#include <array>
+#include <atomic>
 #include <memory>
 #include <string>
 
 #include "base/containers/flat_map.h"
 #include "base/memory/ref_counted.h"
 #include "base/metrics/histogram_base.h"
+#include "base/stl_util.h"
 #include "base/timer/timer.h"
 #include "brave/components/brave_prochlo/brave_prochlo_message.h"
 #include "brave/components/p3a/brave_p3a_log_store.h"
+#include "brave/components/p3a/metric_names.h"
 #include "url/gurl.h"
 
 class PrefRegistrySimple;
@@ -47,6 +51,10 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   void Init(
       scoped_refptr<network::SharedURLLoaderFactory> url_loader_factory);
 
+  // Hands the samples still waiting for |FlushPendingSamples()| over to the
+  // log store, so that they are persisted along with local state on shutdown.
+  void OnShutdown();
+
   // BraveP3ALogStore::Delegate
   std::string Serialize(base::StringPiece histogram_name,
                         uint64_t value) override;
@@ -68,14 +76,19 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   void StartScheduledUpload();
 
   // Invoked by callbacks registered by our service. Since these callbacks
-  // can fire on any thread, this method reposts everything to UI thread.
-  void OnHistogramChanged(const char* histogram_name,
+  // can fire on any thread, this method only stores the latest bucket of the
+  // histogram and schedules |FlushPendingSamples()| on UI thread.
+  void OnHistogramChanged(size_t histogram_index,
+                          const char* histogram_name,
                           uint64_t name_hash,
                           base::HistogramBase::Sample sample);
 
-  void OnHistogramChangedOnUI(const char* histogram_name,
-                              base::HistogramBase::Sample sample,
-                              size_t bucket);
+  // Stores the latest bucket of a histogram and schedules a flush unless one
+  // is already pending. May be called on any thread.
+  void StorePendingBucket(size_t histogram_index, uint64_t bucket);
+
+  // Hands the buckets stored since the last flush over to the log store.
+  void FlushPendingSamples();
 
   // Updates or removes a metric from the log.
   void HandleHistogramChange(base::StringPiece histogram_name, size_t bucket);
@@ -109,6 +122,14 @@ class BraveP3AService : public base::RefCountedThreadSafe<BraveP3AService>,
   // the service and its initialization.
   base::flat_map<base::StringPiece, size_t> histogram_values_;
 
+  // Latest bucket of each collected histogram indexed by its position in the
+  // collected histograms list, or a sentinel if it has not changed since the
+  // last flush. Written on any thread, so that a burst of samples results in
+  // a single log update.
+  std::array<std::atomic<uint64_t>, base::size(kCollectedHistograms)>
+      pending_buckets_;
+  std::atomic<bool> flush_scheduled_{false};
+
   // Once fired we restart the overall uploading process.
   base::OneShotTimer rotation_timer_;
 
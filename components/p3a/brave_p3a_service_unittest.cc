@@ -0,0 +1,156 @@
+/* Copyright (c) 2020 The Brave Authors. All rights reserved.
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this file,
+ * You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "brave/components/p3a/brave_p3a_service.h"
+
+#include <memory>
+#include <string>
+
+#include "base/bind.h"
+#include "base/memory/scoped_refptr.h"
+#include "base/metrics/histogram_functions.h"
+#include "base/metrics/statistics_recorder.h"
+#include "base/strings/string_piece.h"
+#include "base/time/time.h"
+#include "base/values.h"
+#include "brave/common/pref_names.h"
+#include "brave/components/brave_referrals/common/pref_names.h"
+#include "brave/components/p3a/metric_names.h"
+#include "components/prefs/pref_change_registrar.h"
+#include "components/prefs/testing_pref_service.h"
+#include "content/public/test/browser_task_environment.h"
+#include "services/network/public/cpp/weak_wrapper_shared_url_loader_factory.h"
+#include "services/network/test/test_url_loader_factory.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+// npm run test -- brave_unit_tests --filter=BraveP3AServiceTest.*
+
+namespace brave {
+
+namespace {
+
+constexpr char kLogsPrefName[] = "p3a.logs";
+constexpr char kLastRotationTimeStampPref[] = "p3a.last_rotation_timestamp";
+constexpr char kTestHistogramName[] = "Brave.Core.IsDefault";
+
+}  // namespace
+
+class BraveP3AServiceTest : public testing::Test {
+ public:
+  BraveP3AServiceTest()
+      : task_environment_(base::test::TaskEnvironment::TimeSource::MOCK_TIME),
+        statistics_recorder_(
+            base::StatisticsRecorder::CreateTemporaryForTesting()),
+        shared_url_loader_factory_(
+            base::MakeRefCounted<network::WeakWrapperSharedURLLoaderFactory>(
+                &url_loader_factory_)) {}
+
+ protected:
+  void SetUp() override {
+    BraveP3AService::RegisterPrefs(local_state_.registry(), false);
+    local_state_.registry()->RegisterStringPref(kWeekOfInstallation,
+                                                std::string());
+    local_state_.registry()->RegisterStringPref(kReferralPromoCode,
+                                                std::string());
+    // Skips the rotation on init, which records a histogram of its own.
+    local_state_.SetTime(kLastRotationTimeStampPref, base::Time::Now());
+
+    service_ = base::MakeRefCounted<BraveP3AService>(&local_state_);
+    service_->InitCallbacks();
+    service_->Init(shared_url_loader_factory_);
+
+    pref_change_registrar_.Init(&local_state_);
+    pref_change_registrar_.Add(
+        kLogsPrefName,
+        base::BindRepeating(&BraveP3AServiceTest::OnLogsPrefChanged,
+                            base::Unretained(this)));
+  }
+
+  void RecordSample(int sample) {
+    base::UmaHistogramExactLinear(kTestHistogramName, sample, 3);
+  }
+
+  std::string GetPersistedValue() {
+    const base::Value* entry =
+        local_state_.GetDictionary(kLogsPrefName)->FindDictKey(
+            kTestHistogramName);
+    if (!entry) {
+      return std::string();
+    }
+    const std::string* value = entry->FindStringKey("value");
+    return value ? *value : std::string();
+  }
+
+  void OnLogsPrefChanged() { pref_writes_count_++; }
+
+  content::BrowserTaskEnvironment task_environment_;
+  std::unique_ptr<base::StatisticsRecorder> statistics_recorder_;
+  network::TestURLLoaderFactory url_loader_factory_;
+  scoped_refptr<network::SharedURLLoaderFactory> shared_url_loader_factory_;
+  TestingPrefServiceSimple local_state_;
+  PrefChangeRegistrar pref_change_registrar_;
+  scoped_refptr<BraveP3AService> service_;
+  size_t pref_writes_count_ = 0;
+};
+
+TEST_F(BraveP3AServiceTest, CoalescesSamples) {
+  RecordSample(0);
+  RecordSample(1);
+  RecordSample(2);
+  task_environment_.RunUntilIdle();
+  EXPECT_EQ(pref_writes_count_, 0u);
+
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(5));
+  EXPECT_EQ(pref_writes_count_, 1u);
+  EXPECT_EQ(GetPersistedValue(), "2");
+
+  // A later burst is flushed separately.
+  RecordSample(1);
+  RecordSample(0);
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(5));
+  EXPECT_EQ(pref_writes_count_, 2u);
+  EXPECT_EQ(GetPersistedValue(), "0");
+}
+
+TEST_F(BraveP3AServiceTest, FlushesSamplesOnShutdown) {
+  RecordSample(1);
+  EXPECT_EQ(pref_writes_count_, 0u);
+
+  service_->OnShutdown();
+  EXPECT_EQ(pref_writes_count_, 1u);
+  EXPECT_EQ(GetPersistedValue(), "1");
+
+  // The delayed flush has nothing left to persist.
+  task_environment_.FastForwardBy(base::TimeDelta::FromSeconds(5));
+  EXPECT_EQ(pref_writes_count_, 1u);
+}
+
+TEST_F(BraveP3AServiceTest, IsActualMetric) {
+  for (const char* histogram_name : kCollectedHistograms) {
+    EXPECT_TRUE(service_->IsActualMetric(histogram_name)) << histogram_name;
+  }
+
+  // Only the first |size()| characters of the name are looked up.
+  EXPECT_TRUE(service_->IsActualMetric(
+      base::StringPiece("Brave.Core.TabCount.Extra", 19)));
+
+  constexpr const char* kNearMisses[] = {
+      "",
+      "Brave.Core.TabCoun",
+      "Brave.Core.TabCount ",
+      "Brave.Core.TabCount.2",
+      "brave.core.tabcount",
+      "Brave.Core.BookmarksCountOnProfileLoad",
+      "Brave.Search.DefaultEngine.3",
+      "Brave.P2A.AdImpressionsPerSegment.",
+      "Brave.P2A.AdImpressionsPerSegment.unknown",
+      "Tabs.TabCount",
+  };
+  for (const char* histogram_name : kNearMisses) {
+    EXPECT_FALSE(service_->IsActualMetric(histogram_name)) << histogram_name;
+  }
+}
+
+}  // namespace brave
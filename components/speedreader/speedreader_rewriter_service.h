@@ -44,6 +44,12 @@ class SpeedreaderRewriterService : public SpeedreaderComponent::Observer {
   // The API
   bool IsWhitelisted(const GURL& url);
   std::unique_ptr<Rewriter> MakeRewriter(const GURL& url);
+  // Makes a streaming rewriter which calls |output_sink| with every new chunk
+  // of output instead of accumulating it.
+  std::unique_ptr<Rewriter> MakeRewriter(
+      const GURL& url,
+      void (*output_sink)(const char*, size_t, void*),
+      void* output_sink_user_data);
   const std::string& GetContentStylesheet();
 
  private:
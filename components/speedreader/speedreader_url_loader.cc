@@ -11,7 +11,9 @@
 
 #include "base/bind.h"
 #include "base/metrics/histogram_macros.h"
+#include "base/sequence_checker.h"
 #include "base/task/post_task.h"
+#include "base/task_runner_util.h"
 #include "brave/components/speedreader/rust/ffi/speedreader.h"
 #include "brave/components/speedreader/speedreader_rewriter_service.h"
 #include "brave/components/speedreader/speedreader_throttle.h"
@@ -24,8 +26,80 @@ namespace {
 
 constexpr uint32_t kReadBufferSize = 32768;
 
+// TODO(brave-browser/issues/10372): would be better to pass explicit signal
+// back from rewriter to indicate if content was found
+constexpr size_t kMinDistilledBodySize = 1024;
+
 }  // namespace
 
+// Feeds the body to a streaming speedreader::Rewriter chunk by chunk as it is
+// received, so that only the end of distilling is left once the whole body
+// has arrived. Created on the loader's sequence, then used and destroyed on
+// the distill task runner.
+class SpeedReaderURLLoader::Distiller {
+ public:
+  Distiller(SpeedreaderRewriterService* rewriter_service, const GURL& url)
+      : output_(rewriter_service->GetContentStylesheet()),
+        stylesheet_size_(output_.size()) {
+    // Distilled output is appended directly after the stylesheet.
+    rewriter_ = rewriter_service->MakeRewriter(url, &Distiller::OnOutput, this);
+    DETACH_FROM_SEQUENCE(sequence_checker_);
+  }
+
+  ~Distiller() { DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_); }
+
+  Distiller(const Distiller&) = delete;
+  Distiller& operator=(const Distiller&) = delete;
+
+  void Write(std::string chunk) {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    if (!failed_) {
+      const base::TimeTicks start_time = base::TimeTicks::Now();
+      // Error occurred
+      if (rewriter_->Write(chunk.data(), chunk.length()) != 0) {
+        failed_ = true;
+      }
+      distill_time_ += base::TimeTicks::Now() - start_time;
+    }
+
+    // Keep the untouched body in case the page can't be distilled.
+    body_.append(chunk);
+  }
+
+  // Returns either the distilled or the untouched body.
+  std::string End() {
+    DCHECK_CALLED_ON_VALID_SEQUENCE(sequence_checker_);
+    if (!failed_) {
+      const base::TimeTicks start_time = base::TimeTicks::Now();
+      rewriter_->End();
+      distill_time_ += base::TimeTicks::Now() - start_time;
+    }
+
+    UMA_HISTOGRAM_TIMES("Brave.Speedreader.Distill", distill_time_);
+
+    if (failed_ ||
+        output_.length() - stylesheet_size_ < kMinDistilledBodySize) {
+      return std::move(body_);
+    }
+
+    return std::move(output_);
+  }
+
+ private:
+  static void OnOutput(const char* chunk, size_t chunk_len, void* user_data) {
+    static_cast<Distiller*>(user_data)->output_.append(chunk, chunk_len);
+  }
+
+  std::string body_;
+  std::string output_;
+  const size_t stylesheet_size_;
+  std::unique_ptr<Rewriter> rewriter_;
+  bool failed_ = false;
+  base::TimeDelta distill_time_;
+
+  SEQUENCE_CHECKER(sequence_checker_);
+};
+
 // static
 std::tuple<mojo::PendingRemote<network::mojom::URLLoader>,
            mojo::PendingReceiver<network::mojom::URLLoaderClient>,
@@ -68,7 +142,10 @@ SpeedReaderURLLoader::SpeedReaderURLLoader(
       body_producer_watcher_(FROM_HERE,
                              mojo::SimpleWatcher::ArmingPolicy::MANUAL,
                              std::move(task_runner)),
-      rewriter_service_(rewriter_service) {}
+      rewriter_service_(rewriter_service),
+      distill_task_runner_(base::CreateSequencedTaskRunner(
+          {base::ThreadPool(), base::TaskPriority::USER_BLOCKING})),
+      distiller_(nullptr, base::OnTaskRunnerDeleter(distill_task_runner_)) {}
 
 SpeedReaderURLLoader::~SpeedReaderURLLoader() = default;
 
@@ -118,6 +195,10 @@ void SpeedReaderURLLoader::OnStartLoadingResponseBody(
     mojo::ScopedDataPipeConsumerHandle body) {
   VLOG(2) << __func__ << " " << response_url_;
   state_ = State::kLoading;
+  loading_start_time_ = base::TimeTicks::Now();
+  if (rewriter_service_) {
+    distiller_.reset(new Distiller(rewriter_service_, response_url_));
+  }
   body_consumer_handle_ = std::move(body);
   body_consumer_watcher_.Watch(
       body_consumer_handle_.get(),
@@ -190,17 +271,15 @@ void SpeedReaderURLLoader::ResumeReadingBodyFromNet() {
 void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
   DCHECK_EQ(State::kLoading, state_);
 
-  size_t start_size = buffered_body_.size();
+  std::string chunk(kReadBufferSize, '\0');
   uint32_t read_bytes = kReadBufferSize;
-  buffered_body_.resize(start_size + read_bytes);
   MojoResult result = body_consumer_handle_->ReadData(
-      &buffered_body_[0] + start_size, &read_bytes, MOJO_READ_DATA_FLAG_NONE);
+      &chunk[0], &read_bytes, MOJO_READ_DATA_FLAG_NONE);
   switch (result) {
     case MOJO_RESULT_OK:
       break;
     case MOJO_RESULT_FAILED_PRECONDITION:
       // Reading is finished.
-      buffered_body_.resize(start_size);
       MaybeLaunchSpeedreader();
       return;
     case MOJO_RESULT_SHOULD_WAIT:
@@ -212,11 +291,17 @@ void SpeedReaderURLLoader::OnBodyReadable(MojoResult) {
   }
 
   DCHECK_EQ(MOJO_RESULT_OK, result);
-  buffered_body_.resize(start_size + read_bytes);
-  // TODO(iefremov): We actually can partially |pumpContent| to speedreader,
-  // but skipping it for now to simplify things. Pumping is not free in terms
-  // of CPU ticks, so we will have to keep alive speedreader instance on another
-  // thread.
+  chunk.resize(read_bytes);
+  body_size_ += read_bytes;
+
+  if (distiller_) {
+    // |distiller_| is deleted on the distill task runner after any pending
+    // writes, so it is safe to use it unretained.
+    distill_task_runner_->PostTask(
+        FROM_HERE, base::BindOnce(&Distiller::Write,
+                                  base::Unretained(distiller_.get()),
+                                  std::move(chunk)));
+  }
 
   body_consumer_watcher_.ArmOrNotify();
 }
@@ -232,54 +317,38 @@ void SpeedReaderURLLoader::OnBodyWritable(MojoResult r) {
 
 void SpeedReaderURLLoader::MaybeLaunchSpeedreader() {
   DCHECK_EQ(State::kLoading, state_);
-  if (!throttle_ || !rewriter_service_) {
+  if (!throttle_ || !distiller_) {
     Abort();
     return;
   }
 
-  VLOG(2) << __func__ << " buffered body size = " << buffered_body_.size();
-  bytes_remaining_in_buffer_ = buffered_body_.size();
+  VLOG(2) << __func__ << " body size = " << body_size_;
 
-  if (bytes_remaining_in_buffer_ > 0) {
-    // Offload heavy distilling to another thread.
+  if (body_size_ > 0) {
+    // The body has already been written to the distiller as it arrived, so
+    // only the end of distilling is left. The result isn't streamed to the
+    // client: whether the distilled or the untouched body is sent is only
+    // known once distilling has ended, since the rewriter can fail on a later
+    // chunk or produce too little output to be readable.
     base::PostTaskAndReplyWithResult(
-        FROM_HERE, {base::ThreadPool(), base::TaskPriority::USER_BLOCKING},
-        base::BindOnce(
-            [](std::string data, std::unique_ptr<Rewriter> rewriter,
-               const std::string& stylesheet) -> auto {
-              SCOPED_UMA_HISTOGRAM_TIMER("Brave.Speedreader.Distill");
-              int written = rewriter->Write(data.c_str(), data.length());
-              // Error occurred
-              if (written != 0) {
-                return data;
-              }
-
-              rewriter->End();
-              const std::string& transformed = rewriter->GetOutput();
-
-              // TODO(brave-browser/issues/10372): would be better to pass
-              // explicit signal back from rewriter to indicate if content was
-              // found
-              if (transformed.length() < 1024) {
-                return data;
-              }
-
-              return stylesheet + transformed;
-            },
-            std::move(buffered_body_),
-            rewriter_service_->MakeRewriter(response_url_),
-            rewriter_service_->GetContentStylesheet()),
+        distill_task_runner_.get(), FROM_HERE,
+        base::BindOnce(&Distiller::End, base::Unretained(distiller_.get())),
         base::BindOnce(&SpeedReaderURLLoader::CompleteLoading,
                        weak_factory_.GetWeakPtr()));
     return;
   }
-  CompleteLoading(std::move(buffered_body_));
+  CompleteLoading(std::string());
 }
 
 void SpeedReaderURLLoader::CompleteLoading(std::string body) {
   DCHECK_EQ(State::kLoading, state_);
   state_ = State::kSending;
 
+  UMA_HISTOGRAM_TIMES("Brave.Speedreader.BodyReadyTime",
+                      base::TimeTicks::Now() - loading_start_time_);
+
+  distiller_.reset();
+
   if (!throttle_) {
     Abort();
     return;
@@ -361,6 +430,7 @@ void SpeedReaderURLLoader::SendReceivedBodyToClient() {
 void SpeedReaderURLLoader::Abort() {
   VLOG(2) << __func__ << " " << response_url_;
   state_ = State::kAborted;
+  distiller_.reset();
   body_consumer_watcher_.Cancel();
   body_producer_watcher_.Cancel();
   source_url_loader_.reset();
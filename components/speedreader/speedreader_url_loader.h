@@ -6,6 +6,7 @@
 #ifndef BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_URL_LOADER_H_
 #define BRAVE_COMPONENTS_SPEEDREADER_SPEEDREADER_URL_LOADER_H_
 
+#include <memory>
 #include <string>
 #include <tuple>
 #include <vector>
@@ -13,7 +14,9 @@
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
+#include "base/sequenced_task_runner.h"
 #include "base/strings/string_piece.h"
+#include "base/time/time.h"
 #include "mojo/public/cpp/bindings/binding.h"
 #include "mojo/public/cpp/bindings/pending_receiver.h"
 #include "mojo/public/cpp/bindings/pending_remote.h"
@@ -38,11 +41,11 @@ class SpeedreaderRewriterService;
 //               finished (= OnComplete() is called). When body is provided, the
 //               state is changed to kLoading. Otherwise the state goes to
 //               kCompleted.
-// kLoading: Receives the body from the source loader and distills the page.
-//            The received body is kept in this loader until distilling
-//            is finished. When all body has been received and distilling is
-//            done, this loader will dispatch queued messages like
-//            OnStartLoadingResponseBody() to the destination
+// kLoading: Receives the body from the source loader and streams it to the
+//            distiller as it arrives. The received body is kept by the
+//            distiller until distilling is finished. When all body has been
+//            received and distilling is done, this loader will dispatch queued
+//            messages like OnStartLoadingResponseBody() to the destination
 //            loader client, and then the state is changed to kSending.
 // kSending: Receives the body and sends it to the destination loader client.
 //           The state changes to kCompleted after all data is sent.
@@ -82,6 +85,8 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
                        scoped_refptr<base::SingleThreadTaskRunner> task_runner,
                        SpeedreaderRewriterService* rewriter_service);
 
+  class Distiller;
+
   // network::mojom::URLLoaderClient implementation (called from the source of
   // the response):
   void OnReceiveResponse(
@@ -138,10 +143,20 @@ class SpeedReaderURLLoader : public network::mojom::URLLoaderClient,
   // Set if OnComplete() is called during distilling.
   base::Optional<network::URLLoaderCompletionStatus> complete_status_;
 
-  // Note that this could be replaced by a distilled version.
+  // Either the distilled or the untouched body once loading has completed.
   std::string buffered_body_;
   size_t bytes_remaining_in_buffer_;
 
+  // Size of the body received from the source loader so far.
+  size_t body_size_ = 0;
+
+  base::TimeTicks loading_start_time_;
+
+  // Distilling runs on its own sequence so that the body can be distilled as
+  // it arrives without blocking the loader.
+  scoped_refptr<base::SequencedTaskRunner> distill_task_runner_;
+  std::unique_ptr<Distiller, base::OnTaskRunnerDeleter> distiller_;
+
   mojo::ScopedDataPipeConsumerHandle body_consumer_handle_;
   mojo::ScopedDataPipeProducerHandle body_producer_handle_;
   mojo::SimpleWatcher body_consumer_watcher_;